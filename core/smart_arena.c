@@ -0,0 +1,113 @@
+#include "smart_arena.h"
+#include "smart_memmap.h"
+
+static uint8_t scratch_buffer[SMART_SCRATCH_SIZE] SMART_SECTION_POOL;
+
+/* 静态初始化，main() 中第一次文件系统操作之前即可使用 */
+smart_arena_t smart_scratch = {
+    .base = scratch_buffer,
+    .size = SMART_SCRATCH_SIZE,
+    .used = 0,
+    .high_water = 0,
+    .fail_count = 0,
+    .owner = NULL
+};
+
+void smart_arena_init(smart_arena_t *arena, void *buffer, uint32_t size)
+{
+    if (!arena || !buffer)
+    {
+        return;
+    }
+    
+    arena->base = (uint8_t *)buffer;
+    arena->size = size;
+    arena->used = 0;
+    arena->high_water = 0;
+    arena->fail_count = 0;
+    arena->owner = NULL;
+}
+
+void *smart_arena_alloc(smart_arena_t *arena, uint32_t size)
+{
+    if (!arena || size == 0)
+    {
+        return NULL;
+    }
+    
+    smart_task_t current = smart_get_current_task();
+    uint32_t aligned = (size + SMART_ARENA_ALIGN - 1u) & ~(SMART_ARENA_ALIGN - 1u);
+    void *ptr = NULL;
+    
+    smart_enter_critical();
+    
+    if ((arena->used == 0 || arena->owner == current) &&
+        aligned >= size && aligned <= arena->size - arena->used)
+    {
+        ptr = arena->base + arena->used;
+        arena->owner = current;
+        arena->used += aligned;
+        if (arena->used > arena->high_water)
+        {
+            arena->high_water = arena->used;
+        }
+    }
+    else
+    {
+        arena->fail_count++;
+    }
+    
+    smart_exit_critical();
+    
+    return ptr;
+}
+
+smart_arena_mark_t smart_arena_mark(const smart_arena_t *arena)
+{
+    /* 区域属于其他任务时，本任务的分配只能在它清空之后从 0 开始 */
+    if (!arena || arena->used == 0 || arena->owner != smart_get_current_task())
+    {
+        return 0;
+    }
+    return arena->used;
+}
+
+void smart_arena_reset(smart_arena_t *arena, smart_arena_mark_t mark)
+{
+    if (!arena)
+    {
+        return;
+    }
+    
+    smart_task_t current = smart_get_current_task();
+    
+    smart_enter_critical();
+    
+    /* 其他任务的作用域不能回收属主的分配；位置只能向回收方向移动 */
+    if (arena->used != 0 && arena->owner == current && mark < arena->used)
+    {
+        arena->used = mark;
+    }
+    if (arena->used == 0)
+    {
+        arena->owner = NULL;
+    }
+    
+    smart_exit_critical();
+}
+
+smart_arena_scope_t smart_arena_scope_begin(smart_arena_t *arena)
+{
+    smart_arena_scope_t scope;
+    scope.arena = arena;
+    scope.mark = smart_arena_mark(arena);
+    return scope;
+}
+
+void smart_arena_scope_end(smart_arena_scope_t *scope)
+{
+    if (scope)
+    {
+        smart_arena_reset(scope->arena, scope->mark);
+    }
+}
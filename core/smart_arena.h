@@ -0,0 +1,63 @@
+#ifndef __SMART_ARENA_H__
+#define __SMART_ARENA_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include "smart_core.h"
+
+/* 区域（arena）分配器：在一块连续内存上顺序分配，不单独释放，
+ * 通过 mark/reset 按后进先出整体回收。用于命令或文件系统操作期间的
+ * 临时缓冲区（如 512 字节扇区缓冲），代替大数组局部变量，任务栈因此可以缩小。
+ *
+ * 区域非空时只属于一个任务：其他任务分配会失败（返回 NULL 并计入 fail_count），
+ * 回收到空后自动释放归属。
+ */
+
+#define SMART_ARENA_ALIGN  8u
+
+typedef struct
+{
+    uint8_t *base;
+    uint32_t size;
+    uint32_t used;
+    uint32_t high_water;    /* 历史最高使用量 */
+    uint32_t fail_count;    /* 空间不足或归属冲突导致的分配失败次数 */
+    smart_task_t owner;     /* 当前使用者（used 为 0 时无效） */
+} smart_arena_t;
+
+typedef uint32_t smart_arena_mark_t;
+
+/* 作用域：进入时记录位置，离开时回收其间的全部分配 */
+typedef struct
+{
+    smart_arena_t *arena;
+    smart_arena_mark_t mark;
+} smart_arena_scope_t;
+
+void smart_arena_init(smart_arena_t *arena, void *buffer, uint32_t size);
+
+/* 分配 size 字节（SMART_ARENA_ALIGN 对齐），失败返回 NULL */
+void *smart_arena_alloc(smart_arena_t *arena, uint32_t size);
+
+/* 记录当前位置 / 回收到该位置之后的全部分配 */
+smart_arena_mark_t smart_arena_mark(const smart_arena_t *arena);
+void smart_arena_reset(smart_arena_t *arena, smart_arena_mark_t mark);
+
+smart_arena_scope_t smart_arena_scope_begin(smart_arena_t *arena);
+void smart_arena_scope_end(smart_arena_scope_t *scope);
+
+/* 在当前代码块内声明一个作用域，块结束（包括提前 return）时自动回收 */
+#define SMART_ARENA_SCOPE_NAME2(line)  smart_arena_scope_##line
+#define SMART_ARENA_SCOPE_NAME(line)   SMART_ARENA_SCOPE_NAME2(line)
+#define SMART_ARENA_SCOPE(arena) \
+    smart_arena_scope_t SMART_ARENA_SCOPE_NAME(__LINE__) \
+        __attribute__((cleanup(smart_arena_scope_end), unused)) = smart_arena_scope_begin(arena)
+
+/* 系统共享的临时区域（文件系统扇区缓冲、Shell 命令缓冲） */
+#ifndef SMART_SCRATCH_SIZE
+#define SMART_SCRATCH_SIZE 1024u
+#endif
+
+extern smart_arena_t smart_scratch;
+
+#endif
@@ -0,0 +1,56 @@
+#include "smart_atomic.h"
+#include <stddef.h>
+
+/* ========== 单生产者/单消费者环形队列 ========== */
+
+int smart_spsc_ring_init(smart_spsc_ring_t *ring, uint32_t *buffer, uint32_t capacity)
+{
+    if (!ring || !buffer || smart_spsc_index_init(&ring->index, capacity) != 0)
+    {
+        return -1;
+    }
+    
+    ring->buffer = buffer;
+    
+    return 0;
+}
+
+int smart_spsc_ring_push(smart_spsc_ring_t *ring, uint32_t value)
+{
+    uint32_t slot;
+    
+    if (!smart_spsc_write_slot(&ring->index, &slot))
+    {
+        return 0;  /* 满 */
+    }
+    
+    ring->buffer[slot] = value;
+    smart_spsc_write_commit(&ring->index);
+    
+    return 1;
+}
+
+int smart_spsc_ring_pop(smart_spsc_ring_t *ring, uint32_t *value)
+{
+    uint32_t slot;
+    
+    if (!smart_spsc_read_slot(&ring->index, &slot))
+    {
+        return 0;  /* 空 */
+    }
+    
+    *value = ring->buffer[slot];
+    smart_spsc_read_commit(&ring->index);
+    
+    return 1;
+}
+
+uint32_t smart_spsc_ring_count(const smart_spsc_ring_t *ring)
+{
+    if (!ring)
+    {
+        return 0;
+    }
+    
+    return smart_spsc_index_count(&ring->index);
+}
@@ -0,0 +1,236 @@
+#ifndef __SMART_ATOMIC_H__
+#define __SMART_ATOMIC_H__
+
+#include <stdint.h>
+
+/* Smart-OS 无锁原语：基于 Cortex-M3 LDREX/STREX
+ * 异常进入/返回会清除独占监视器，任务与中断之间的竞争会使 STREX 失败并重试，
+ * 因此这些操作不需要关中断。
+ */
+
+/* ========== 底层指令 ========== */
+
+static inline uint32_t smart_ldrex(volatile uint32_t *addr)
+{
+    uint32_t value;
+    __asm volatile ("ldrex %0, [%1]" : "=r" (value) : "r" (addr) : "memory");
+    return value;
+}
+
+/* 返回 0 表示写入成功 */
+static inline uint32_t smart_strex(uint32_t value, volatile uint32_t *addr)
+{
+    uint32_t fail;
+    __asm volatile ("strex %0, %2, [%1]" : "=&r" (fail) : "r" (addr), "r" (value) : "memory");
+    return fail;
+}
+
+static inline void smart_clrex(void)
+{
+    __asm volatile ("clrex" ::: "memory");
+}
+
+/* 数据内存屏障（发布数据后再更新索引） */
+static inline void smart_dmb(void)
+{
+    __asm volatile ("dmb" ::: "memory");
+}
+
+/* ========== 原子计数器 ========== */
+
+/* 原子加，返回新值 */
+static inline uint32_t smart_atomic_add(volatile uint32_t *addr, uint32_t delta)
+{
+    uint32_t value;
+    do {
+        value = smart_ldrex(addr) + delta;
+    } while (smart_strex(value, addr));
+    return value;
+}
+
+/* 原子减，返回新值 */
+static inline uint32_t smart_atomic_sub(volatile uint32_t *addr, uint32_t delta)
+{
+    uint32_t value;
+    do {
+        value = smart_ldrex(addr) - delta;
+    } while (smart_strex(value, addr));
+    return value;
+}
+
+static inline uint32_t smart_atomic_inc(volatile uint32_t *addr)
+{
+    return smart_atomic_add(addr, 1u);
+}
+
+static inline uint32_t smart_atomic_dec(volatile uint32_t *addr)
+{
+    return smart_atomic_sub(addr, 1u);
+}
+
+/* 原子交换，返回旧值 */
+static inline uint32_t smart_atomic_swap(volatile uint32_t *addr, uint32_t value)
+{
+    uint32_t old;
+    do {
+        old = smart_ldrex(addr);
+    } while (smart_strex(value, addr));
+    return old;
+}
+
+/* 比较并交换，成功返回 1 */
+static inline int smart_atomic_cas(volatile uint32_t *addr, uint32_t expected, uint32_t desired)
+{
+    do {
+        if (smart_ldrex(addr) != expected)
+        {
+            smart_clrex();
+            return 0;
+        }
+    } while (smart_strex(desired, addr));
+    return 1;
+}
+
+/* 大于 0 时减 1，成功返回 1（信号量获取快速路径） */
+static inline int smart_atomic_dec_if_positive(volatile uint32_t *addr)
+{
+    uint32_t value;
+    do {
+        value = smart_ldrex(addr);
+        if (value == 0)
+        {
+            smart_clrex();
+            return 0;
+        }
+    } while (smart_strex(value - 1u, addr));
+    return 1;
+}
+
+/* ========== 单生产者/单消费者环形索引 ==========
+ * 只管理索引，元素存放在使用者自己的数组里（字、消息、字符均可），容量必须为 2 的幂。
+ * tail 只由生产者写，head 只由消费者写，索引自由递增、用掩码取模，
+ * 生产者与消费者可分别位于中断和任务中，无需关中断。
+ * 双方各缓存一份对方索引的快照，只有快照显示满/空时才去读对方的字段。
+ *   生产者：smart_spsc_write_slot 取得槽位 -> 写元素 -> smart_spsc_write_commit
+ *   消费者：smart_spsc_read_slot  取得槽位 -> 读元素 -> smart_spsc_read_commit
+ * SMART_SPSC_ALIGN 控制生产者/消费者字段组的对齐：
+ * Cortex-M3 没有数据缓存，默认按字对齐；移植到带缓存的内核时设为缓存行大小。
+ */
+#ifndef SMART_SPSC_ALIGN
+#define SMART_SPSC_ALIGN 4
+#endif
+
+typedef struct {
+    uint32_t mask;              /* 容量 - 1 */
+    
+    /* 生产者侧 */
+    volatile uint32_t tail __attribute__((aligned(SMART_SPSC_ALIGN)));
+    uint32_t head_cache;        /* 生产者看到的 head 快照 */
+    
+    /* 消费者侧 */
+    volatile uint32_t head __attribute__((aligned(SMART_SPSC_ALIGN)));
+    uint32_t tail_cache;        /* 消费者看到的 tail 快照 */
+} smart_spsc_index_t;
+
+/* 初始化（capacity 不是 2 的幂时返回 -1） */
+static inline int smart_spsc_index_init(smart_spsc_index_t *spsc, uint32_t capacity)
+{
+    if (capacity == 0 || (capacity & (capacity - 1u)) != 0)
+    {
+        return -1;
+    }
+    
+    spsc->mask = capacity - 1u;
+    spsc->tail = 0;
+    spsc->head_cache = 0;
+    spsc->head = 0;
+    spsc->tail_cache = 0;
+    return 0;
+}
+
+/* 生产者：有空位时返回 1，*slot 为可写入的槽位 */
+static inline int smart_spsc_write_slot(smart_spsc_index_t *spsc, uint32_t *slot)
+{
+    uint32_t tail = spsc->tail;
+    
+    if (tail - spsc->head_cache > spsc->mask)
+    {
+        spsc->head_cache = spsc->head;
+        if (tail - spsc->head_cache > spsc->mask)
+        {
+            return 0;  /* 满 */
+        }
+    }
+    
+    *slot = tail & spsc->mask;
+    return 1;
+}
+
+/* 生产者：元素写完后发布 */
+static inline void smart_spsc_write_commit(smart_spsc_index_t *spsc)
+{
+    /* 先写数据再发布索引 */
+    smart_dmb();
+    spsc->tail = spsc->tail + 1u;
+}
+
+/* 消费者：有数据时返回 1，*slot 为可读取的槽位 */
+static inline int smart_spsc_read_slot(smart_spsc_index_t *spsc, uint32_t *slot)
+{
+    uint32_t head = spsc->head;
+    
+    if (head == spsc->tail_cache)
+    {
+        spsc->tail_cache = spsc->tail;
+        if (head == spsc->tail_cache)
+        {
+            return 0;  /* 空 */
+        }
+    }
+    
+    smart_dmb();
+    *slot = head & spsc->mask;
+    return 1;
+}
+
+/* 消费者：元素读完后释放槽位 */
+static inline void smart_spsc_read_commit(smart_spsc_index_t *spsc)
+{
+    smart_dmb();
+    spsc->head = spsc->head + 1u;
+}
+
+/* 消费者：丢弃当前全部数据 */
+static inline void smart_spsc_read_flush(smart_spsc_index_t *spsc)
+{
+    spsc->tail_cache = spsc->tail;
+    spsc->head = spsc->tail_cache;
+}
+
+/* 当前元素数量（任一侧均可调用） */
+static inline uint32_t smart_spsc_index_count(const smart_spsc_index_t *spsc)
+{
+    return spsc->tail - spsc->head;
+}
+
+/* ========== 单生产者/单消费者字队列 ==========
+ * 基于上面的环形索引，元素为 32 位字（数值或指针）。
+ */
+typedef struct {
+    volatile uint32_t *buffer;  /* 元素缓冲区 */
+    smart_spsc_index_t index;
+} smart_spsc_ring_t;
+
+/* 初始化（capacity 不是 2 的幂时返回 -1） */
+int smart_spsc_ring_init(smart_spsc_ring_t *ring, uint32_t *buffer, uint32_t capacity);
+
+/* 生产者写入，满时返回 0 */
+int smart_spsc_ring_push(smart_spsc_ring_t *ring, uint32_t value);
+
+/* 消费者读取，空时返回 0 */
+int smart_spsc_ring_pop(smart_spsc_ring_t *ring, uint32_t *value);
+
+/* 当前元素数量 */
+uint32_t smart_spsc_ring_count(const smart_spsc_ring_t *ring);
+
+#endif
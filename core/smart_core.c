@@ -2,6 +2,7 @@
 #include "smart_uart.h"
 #include "smart_mempool.h"
 #include "smart_timer.h"
+#include "smart_memmap.h"
 
 #ifndef SMART_LOG_ENABLED
 #define SMART_LOG_ENABLED 0  /* 关闭日志避免刷屏 */
@@ -40,6 +41,11 @@ static inline void smart_log_task_info(const char *prefix, smart_task_t task)
 #define SYSTICK_LOAD   (*(volatile uint32_t *)0xE000E014)
 #define SYSTICK_VAL    (*(volatile uint32_t *)0xE000E018)
 #define SCB_SHPR3      (*(volatile uint32_t *)0xE000ED20)
+#define SCB_ICSR       (*(volatile uint32_t *)0xE000ED04)
+#define SCB_SHPR_BASE  ((volatile uint8_t *)0xE000ED18)  /* 系统异常 4-15 优先级 */
+#define NVIC_IPR_BASE  ((volatile uint8_t *)0xE000E400)  /* 外部中断优先级 */
+
+#define ICSR_PENDSTSET (1u << 26)
 
 #define STACK_GUARD_PATTERN 0xDEADBEEF
 
@@ -54,9 +60,15 @@ volatile smart_time_t os_tick = 0;
 /* 临界区嵌套计数 */
 static volatile uint32_t critical_nesting = 0;
 
+#if SMART_CRITICAL_STATS
+static uint32_t critical_enter_cycles;
+static uint32_t critical_enter_site;
+static smart_critical_stats_t critical_stats;
+#endif
+
 /* Idle任务 */
 static struct smart_task idle_task;
-static uint8_t idle_stack[256];
+static uint8_t idle_stack[256] SMART_SECTION_STACK;
 static void idle_task_entry(void *param);
 
 /* 栈保护 */
@@ -133,25 +145,94 @@ extern void start_first_task(void);
 /* 内联汇编：中断控制 */
 static inline void __smart_disable_irq(void)
 {
+#if SMART_KERNEL_IRQ_CEILING
+    /* 只屏蔽优先级不高于上限的中断 */
+    __asm volatile ("MSR BASEPRI, %0\n ISB" :: "r" (SMART_KERNEL_IRQ_CEILING) : "memory");
+#else
     __asm volatile ("CPSID I" ::: "memory");
+#endif
 }
 
 static inline void __smart_enable_irq(void)
 {
+#if SMART_KERNEL_IRQ_CEILING
+    __asm volatile ("MSR BASEPRI, %0" :: "r" (0) : "memory");
+#else
     __asm volatile ("CPSIE I" ::: "memory");
+#endif
 }
 
+#if SMART_KERNEL_IRQ_CEILING && SMART_IRQ_CEILING_CHECK
+/* 优先级高于上限的中断不受临界区保护，禁止调用内核 API */
+static void smart_check_irq_priority(void)
+{
+    uint32_t ipsr;
+    __asm volatile ("MRS %0, IPSR" : "=r" (ipsr));
+    ipsr &= 0x1FFu;
+    
+    if (ipsr == 0)
+    {
+        return;  /* 线程模式 */
+    }
+    
+    uint8_t priority = 0;  /* NMI / HardFault 优先级固定且更高 */
+    if (ipsr >= 16)
+    {
+        priority = NVIC_IPR_BASE[ipsr - 16];
+    }
+    else if (ipsr >= 4)
+    {
+        priority = SCB_SHPR_BASE[ipsr - 4];
+    }
+    
+    if (priority < SMART_KERNEL_IRQ_CEILING)
+    {
+        smart_uart_print("[SmartOS][Fatal] Kernel API called above IRQ ceiling!\n");
+        smart_uart_print("  Exception: 0x");
+        smart_uart_print_hex32(ipsr);
+        smart_uart_print(" priority: 0x");
+        smart_uart_print_hex32(priority);
+        smart_uart_print("\n");
+        smart_uart_print("System halted.\n");
+        while(1);
+    }
+}
+#endif
+
 /* 临界区保护 */
 void smart_enter_critical(void)
 {
+#if SMART_KERNEL_IRQ_CEILING && SMART_IRQ_CEILING_CHECK
+    smart_check_irq_priority();
+#endif
     __smart_disable_irq();
     critical_nesting++;
+    
+#if SMART_CRITICAL_STATS
+    if (critical_nesting == 1)
+    {
+        critical_enter_site = (uint32_t)__builtin_return_address(0);
+        critical_enter_cycles = smart_get_cycles();
+    }
+#endif
 }
 
 void smart_exit_critical(void)
 {
     if (critical_nesting > 0)
     {
+#if SMART_CRITICAL_STATS
+        if (critical_nesting == 1)
+        {
+            uint32_t cycles = smart_get_cycles() - critical_enter_cycles;
+            critical_stats.enter_count++;
+            if (cycles > critical_stats.max_cycles)
+            {
+                critical_stats.max_cycles = cycles;
+                critical_stats.max_site = critical_enter_site;
+            }
+        }
+#endif
         critical_nesting--;
         if (critical_nesting == 0)
         {
@@ -160,6 +241,33 @@ void smart_exit_critical(void)
     }
 }
 
+void smart_get_critical_stats(smart_critical_stats_t *stats)
+{
+    if (!stats) return;
+    
+    smart_enter_critical();
+#if SMART_CRITICAL_STATS
+    *stats = critical_stats;
+#else
+    stats->enter_count = 0;
+    stats->max_cycles = 0;
+    stats->max_site = 0;
+#endif
+    stats->ceiling = SMART_KERNEL_IRQ_CEILING;
+    smart_exit_critical();
+}
+
+void smart_reset_critical_stats(void)
+{
+#if SMART_CRITICAL_STATS
+    smart_enter_critical();
+    critical_stats.enter_count = 0;
+    critical_stats.max_cycles = 0;
+    critical_stats.max_site = 0;
+    smart_exit_critical();
+#endif
+}
+
 /* Cortex-M3 栈初始化 */
 static uint8_t *hw_stack_init(void (*tentry)(void*), void *parameter, uint8_t *stack_addr)
 {
@@ -170,7 +278,7 @@ static uint8_t *hw_stack_init(void (*tentry)(void*), void *parameter, uint8_t *s
     /* 关键修正：强制设置 PC 的 Bit 0 为 1，确保处于 Thumb 模式 */
     *(--stk) = (unsigned long)tentry | 1; /* PC */
     
-    *(--stk) = 0; /* LR */
+    *(--stk) = (unsigned long)smart_task_exit | 1; /* LR：入口函数返回后结束任务 */
     *(--stk) = 0; /* R12 */
     *(--stk) = 0; /* R3 */
     *(--stk) = 0; /* R2 */
@@ -237,6 +345,16 @@ void smart_task_create(smart_task_t task,
     /* 初始化时间属性 */
     task->arrival = os_tick; 
     task->wakeup_time = 0;
+    
+    /* 初始化阻塞状态 */
+    task->wait_next = 0;
+    task->wait_queue = 0;
+    task->wait_timeout = SMART_WAIT_FOREVER;
+    task->wait_value = 0;
+    task->wait_obj = 0;
+    task->wait_flags = 0;
+    task->wait_result = SMART_WAIT_OK;
+    task->alloc_cache = 0;
     if (period > 0)
         task->deadline = os_tick + relative_deadline;
     else
@@ -371,6 +489,36 @@ void smart_task_yield(void)
     smart_log_task_info("[SmartOS] Task yield", current_task);
 }
 
+void smart_task_exit(void)
+{
+    smart_task_t task = current_task;
+
+#if SMART_MEMPOOL_CACHE
+    /* 归还可能要等待限流恢复，在临界区外进行 */
+    smart_mempool_cache_flush_task(task);
+#endif
+    
+    smart_enter_critical();
+    
+    smart_task_t *link = &task_list;
+    while (*link && *link != task)
+    {
+        link = &(*link)->next;
+    }
+    if (*link)
+    {
+        *link = task->next;
+    }
+    task->next = 0;
+    task->state = TASK_STATE_EXIT;
+    
+    smart_schedule();
+    smart_exit_critical();
+    
+    /* PendSV 在退出临界区后立即切换，不会执行到这里 */
+    while (1);
+}
+
 smart_time_t smart_get_tick(void)
 {
     return os_tick;
@@ -381,6 +529,27 @@ smart_time_t smart_get_tick_count(void)
     return os_tick;
 }
 
+uint32_t smart_get_cycles(void)
+{
+    smart_time_t tick;
+    uint32_t val;
+    
+    /* 读取期间若发生 tick 则重读 */
+    do {
+        tick = os_tick;
+        val = SYSTICK_VAL;
+    } while (tick != os_tick);
+    
+    /* 临界区内 SysTick 已溢出但尚未处理：补上这一个 tick */
+    if (SCB_ICSR & ICSR_PENDSTSET)
+    {
+        val = SYSTICK_VAL;
+        tick++;
+    }
+    
+    return tick * (SYSTICK_LOAD + 1u) + (SYSTICK_LOAD - val);
+}
+
 /* 延时指定 tick 数 */
 void smart_delay(smart_time_t ticks)
 {
@@ -405,6 +574,73 @@ void smart_delay(smart_time_t ticks)
     smart_exit_critical();
 }
 
+/* 等待队列按 deadline 升序排列，deadline 相同者先来先服务 */
+void smart_wait_queue_insert(smart_task_t *wait_queue, smart_task_t task)
+{
+    smart_task_t *link = wait_queue;
+    
+    while (*link && (*link)->deadline <= task->deadline)
+    {
+        link = &(*link)->wait_next;
+    }
+    
+    task->wait_next = *link;
+    task->wait_queue = wait_queue;
+    *link = task;
+}
+
+void smart_wait_queue_remove(smart_task_t task)
+{
+    if (!task || !task->wait_queue) return;
+    
+    smart_task_t *link = task->wait_queue;
+    while (*link && *link != task)
+    {
+        link = &(*link)->wait_next;
+    }
+    if (*link)
+    {
+        *link = task->wait_next;
+    }
+    
+    task->wait_next = 0;
+    task->wait_queue = 0;
+}
+
+/* 阻塞当前任务，直到被 smart_task_wakeup 唤醒或超时 */
+uint8_t smart_task_block(smart_task_t *wait_queue, smart_time_t timeout)
+{
+    smart_task_t task = current_task;
+    
+    if (!task || !wait_queue || timeout == 0)
+    {
+        return SMART_WAIT_TIMEOUT;
+    }
+    
+    task->wait_result = SMART_WAIT_TIMEOUT;
+    task->wait_timeout = (timeout == SMART_WAIT_FOREVER) ? SMART_WAIT_FOREVER : os_tick + timeout;
+    task->state = TASK_STATE_BLOCKED;
+    smart_wait_queue_insert(wait_queue, task);
+    
+    smart_schedule();
+    
+    /* 退出临界区后 PendSV 完成切换，被唤醒后从这里继续 */
+    smart_exit_critical();
+    smart_enter_critical();
+    
+    return task->wait_result;
+}
+
+void smart_task_wakeup(smart_task_t task, uint8_t result)
+{
+    if (!task || task->state != TASK_STATE_BLOCKED) return;
+    
+    smart_wait_queue_remove(task);
+    task->wait_timeout = SMART_WAIT_FOREVER;
+    task->wait_result = result;
+    task->state = TASK_STATE_READY;
+}
+
 /* SVC Handler 的 C 部分 - 用于调试 */
 void SVC_Handler_C(void)
 {
@@ -428,7 +664,6 @@ extern volatile int count_b;
 void SysTick_Handler(void)
 {
     os_tick++;
-    smart_mempool_tick();
     smart_timer_tick();  /* 处理软件定时器 */
     
     /* 每 1000 ticks (1秒) 打印一次计数器状态（仅在测试模式下） */
@@ -478,6 +713,17 @@ void SysTick_Handler(void)
                 SMART_LOG("[SmartOS] Task delay expired, wakeup\n");
             }
         }
+        else if (node->state == TASK_STATE_BLOCKED)
+        {
+            if (node->wait_timeout != SMART_WAIT_FOREVER && os_tick >= node->wait_timeout)
+            {
+                /* 高优先级中断可能同时操作等待队列 */
+                smart_enter_critical();
+                smart_task_wakeup(node, SMART_WAIT_TIMEOUT);
+                smart_exit_critical();
+                need_sched = 1;
+            }
+        }
         node = node->next;
     }
     
@@ -601,3 +847,11 @@ smart_task_t smart_get_current_task(void)
 {
     return current_task;
 }
+
+/* 是否处于中断（异常）上下文 */
+int smart_in_isr(void)
+{
+    uint32_t ipsr;
+    __asm volatile ("MRS %0, IPSR" : "=r" (ipsr));
+    return (ipsr & 0x1FFu) != 0;
+}
@@ -11,9 +11,36 @@
 #define TASK_STATE_WAITING  3  /* 等待下一个周期 */
 #define TASK_STATE_DELAYED  5  /* 延时等待 */
 #define TASK_STATE_SUSPEND  4  /* 挂起状态 */
+#define TASK_STATE_BLOCKED  6  /* 阻塞在内核对象上（信号量/事件组等） */
+#define TASK_STATE_EXIT     7  /* 已退出，不再参与调度 */
+
+/* 等待超时：永久等待 */
+#define SMART_WAIT_FOREVER  0xFFFFFFFFu
+
+/* 阻塞唤醒原因 */
+#define SMART_WAIT_OK       0  /* 被内核对象唤醒 */
+#define SMART_WAIT_TIMEOUT  1  /* 等待超时 */
 
 typedef uint32_t smart_time_t;
 
+/* 内核中断优先级上限（写入 BASEPRI 的值，LM3S 仅高 3 位有效）
+ * 临界区只屏蔽优先级数值 >= 上限的中断，更高优先级的中断始终不受内核影响，
+ * 但这些中断不得调用任何内核 API。设为 0 则退回 CPSID I 全局关中断。
+ */
+#ifndef SMART_KERNEL_IRQ_CEILING
+#define SMART_KERNEL_IRQ_CEILING 0x40
+#endif
+
+/* 在中断中进入临界区时检查中断优先级是否低于上限 */
+#ifndef SMART_IRQ_CEILING_CHECK
+#define SMART_IRQ_CEILING_CHECK 1
+#endif
+
+/* 记录最长临界区及其调用位置 */
+#ifndef SMART_CRITICAL_STATS
+#define SMART_CRITICAL_STATS 1
+#endif
+
 /* 任务控制块 */
 struct smart_task {
     void *sp;               /* 栈指针 (必须在首位) */
@@ -42,6 +69,17 @@ struct smart_task {
     smart_time_t max_exec_time;      /* 最大执行时间 */
     uint32_t deadline_miss_count;    /* 错过截止时间次数 */
     
+    /* 内核对象阻塞（与 next 分离，不破坏任务链表） */
+    struct smart_task *wait_next;    /* 等待队列链表，按 deadline 排序 */
+    struct smart_task **wait_queue;  /* 当前所在的等待队列 */
+    smart_time_t wait_timeout;       /* 超时时刻（绝对 tick），FOREVER 表示无超时 */
+    uint32_t wait_value;             /* 对象私有参数（如等待的事件位） */
+    void *wait_obj;                  /* 关联对象（如条件变量绑定的互斥锁） */
+    uint8_t wait_flags;              /* 对象私有选项 */
+    uint8_t wait_result;             /* 唤醒原因 SMART_WAIT_xxx */
+    
+    void *alloc_cache;               /* 内存池每任务缓存链表（smart_mempool_cache_t） */
+    
     struct smart_task *next;
 };
 
@@ -66,13 +104,45 @@ void smart_task_create(smart_task_t task,
 /* 任务主动放弃 CPU，等待下一个周期 */
 void smart_task_yield(void);
 
+/* 结束当前任务：归还每任务内存池缓存，从任务链表移除后切换出去，不再返回。
+ * 任务入口函数返回时自动调用。任务持有的互斥锁等不会自动释放。
+ */
+void smart_task_exit(void);
+
 /* 临界区保护 */
 void smart_enter_critical(void);
 void smart_exit_critical(void);
 
+/* 临界区统计 */
+typedef struct {
+    uint32_t enter_count;   /* 最外层临界区进入次数 */
+    uint32_t max_cycles;    /* 观察到的最长临界区（CPU周期） */
+    uint32_t max_site;      /* 最长临界区的调用位置（smart_enter_critical 的返回地址） */
+    uint32_t ceiling;       /* 当前配置的优先级上限，0 表示全局关中断 */
+} smart_critical_stats_t;
+
+void smart_get_critical_stats(smart_critical_stats_t *stats);
+void smart_reset_critical_stats(void);
+
+/* 内核阻塞机制（均需在临界区内调用）
+ * smart_task_block: 将当前任务按 deadline 插入等待队列并切换出去，
+ *   返回时已重新进入临界区，返回值为唤醒原因。调用前临界区嵌套深度必须为 1。
+ * smart_task_wakeup: 将任务从其等待队列移出并置为就绪，调用者负责之后调度。
+ */
+uint8_t smart_task_block(smart_task_t *wait_queue, smart_time_t timeout);
+void smart_task_wakeup(smart_task_t task, uint8_t result);
+void smart_wait_queue_insert(smart_task_t *wait_queue, smart_task_t task);
+void smart_wait_queue_remove(smart_task_t task);
+
+/* 调度器（选择 deadline 最小的就绪任务） */
+void smart_schedule(void);
+
 /* 获取当前系统时间 */
 smart_time_t smart_get_tick(void);
 
+/* 获取 CPU 周期计数（基于 SysTick，用于短时间测量，关中断期间跨 tick 不准确） */
+uint32_t smart_get_cycles(void);
+
 /* 延时指定 tick 数 */
 void smart_delay(smart_time_t ticks);
 
@@ -97,5 +167,8 @@ int smart_get_task_list(smart_task_info_t *info_array, int max_tasks);
 /* 获取当前运行任务 */
 smart_task_t smart_get_current_task(void);
 
+/* 是否处于中断（异常）上下文 */
+int smart_in_isr(void);
+
 
 #endif
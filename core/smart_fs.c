@@ -1,6 +1,7 @@
 #include "smart_fs.h"
 #include "smart_core.h"
 #include "smart_uart.h"
+#include "smart_arena.h"
 #include <string.h>
 
 /* FAT12 BPB（BIOS Parameter Block）结构 */
@@ -137,7 +138,12 @@ static void filename_to_83(const char *filename, char *name83)
 static smart_fs_status_t find_file_in_root(const char *filename, fat12_dirent_t *dirent)
 {
     char name83[11];
-    uint8_t sector_buffer[512];
+    SMART_ARENA_SCOPE(&smart_scratch);
+    uint8_t *sector_buffer = (uint8_t *)smart_arena_alloc(&smart_scratch, 512);
+    if (!sector_buffer)
+    {
+        return SMART_FS_ERROR;
+    }
     
     filename_to_83(filename, name83);
     
@@ -186,8 +192,13 @@ smart_fs_status_t smart_fs_init(smart_block_device_t *dev)
     
     fs_device = dev;
     
-    /* 读取引导扇区 - 必须使用完整的 512 字节缓冲区 */
-    uint8_t sector_buffer[512];
+    /* 读取引导扇区 - 必须使用完整的 512 字节缓冲区（取自共享临时区域，返回时回收） */
+    SMART_ARENA_SCOPE(&smart_scratch);
+    uint8_t *sector_buffer = (uint8_t *)smart_arena_alloc(&smart_scratch, 512);
+    if (!sector_buffer)
+    {
+        return SMART_FS_ERROR;
+    }
     smart_block_status_t read_status = smart_block_read(dev, 0, sector_buffer, 1);
     
     if (read_status != SMART_BLOCK_OK)
@@ -240,7 +251,12 @@ smart_fs_status_t smart_fs_format(smart_block_device_t *dev)
     smart_uart_print_hex32(dev->total_sectors);
     smart_uart_print("\n");
     
-    uint8_t sector_buffer[512];
+    SMART_ARENA_SCOPE(&smart_scratch);
+    uint8_t *sector_buffer = (uint8_t *)smart_arena_alloc(&smart_scratch, 512);
+    if (!sector_buffer)
+    {
+        return SMART_FS_ERROR;
+    }
     uint32_t total_sectors = dev->total_sectors;
     
     /* 计算FAT12参数 */
@@ -348,14 +364,13 @@ smart_fs_status_t smart_fs_format(smart_block_device_t *dev)
     
     /* 验证写入：读回 boot sector 检查 */
     smart_uart_print("[FS] Verifying format...\n");
-    uint8_t verify_buffer[512];
-    if (smart_block_read(dev, 0, verify_buffer, 1) == SMART_BLOCK_OK)
+    if (smart_block_read(dev, 0, sector_buffer, 1) == SMART_BLOCK_OK)
     {
-        fat12_bpb_t *verify_bpb = (fat12_bpb_t *)verify_buffer;
+        fat12_bpb_t *verify_bpb = (fat12_bpb_t *)sector_buffer;
         smart_uart_print("[FS] Verify: bytes_per_sector=");
         smart_uart_print_hex32(verify_bpb->bytes_per_sector);
         smart_uart_print(", signature=0x");
-        smart_uart_print_hex32((verify_buffer[510] << 8) | verify_buffer[511]);
+        smart_uart_print_hex32((sector_buffer[510] << 8) | sector_buffer[511]);
         smart_uart_print("\n");
     }
     
@@ -412,7 +427,12 @@ smart_fs_status_t smart_fs_read(smart_file_t *file, void *buffer, uint32_t size,
     
     uint8_t *dst = (uint8_t *)buffer;
     uint32_t total_read = 0;
-    uint8_t sector_buffer[512];
+    SMART_ARENA_SCOPE(&smart_scratch);
+    uint8_t *sector_buffer = (uint8_t *)smart_arena_alloc(&smart_scratch, 512);
+    if (!sector_buffer)
+    {
+        return SMART_FS_ERROR;
+    }
     
     /* 计算起始位置所在的簇和扇区 */
     uint32_t bytes_per_cluster = sectors_per_cluster * 512;
@@ -532,7 +552,12 @@ smart_fs_status_t smart_fs_write(smart_file_t *file, const void *buffer, uint32_
     
     const uint8_t *src = (const uint8_t *)buffer;
     uint32_t total_written = 0;
-    uint8_t sector_buffer[512];
+    SMART_ARENA_SCOPE(&smart_scratch);
+    uint8_t *sector_buffer = (uint8_t *)smart_arena_alloc(&smart_scratch, 512);
+    if (!sector_buffer)
+    {
+        return SMART_FS_ERROR;
+    }
     
     /* 如果文件为空，分配第一个簇 */
     if (file->first_cluster == 0)
@@ -628,7 +653,12 @@ smart_fs_status_t smart_fs_write(smart_file_t *file, const void *buffer, uint32_
 smart_fs_status_t smart_fs_update_file_info(const char *filename, uint16_t first_cluster, uint32_t file_size)
 {
     char name83[11];
-    uint8_t sector_buffer[512];
+    SMART_ARENA_SCOPE(&smart_scratch);
+    uint8_t *sector_buffer = (uint8_t *)smart_arena_alloc(&smart_scratch, 512);
+    if (!sector_buffer)
+    {
+        return SMART_FS_ERROR;
+    }
     
     filename_to_83(filename, name83);
     
@@ -690,7 +720,12 @@ smart_fs_status_t smart_fs_close(smart_file_t *file)
 smart_fs_status_t smart_fs_list_dir(const char *dirname)
 {
     (void)dirname;
-    uint8_t sector_buffer[512];
+    SMART_ARENA_SCOPE(&smart_scratch);
+    uint8_t *sector_buffer = (uint8_t *)smart_arena_alloc(&smart_scratch, 512);
+    if (!sector_buffer)
+    {
+        return SMART_FS_ERROR;
+    }
     
     if (!fs_device || root_dir_start_sector == 0)
     {
@@ -802,7 +837,12 @@ smart_fs_status_t smart_fs_create(const char *filename)
             ext[i] = ext[i] - 'a' + 'A';
     }
     
-    uint8_t sector_buffer[512];
+    SMART_ARENA_SCOPE(&smart_scratch);
+    uint8_t *sector_buffer = (uint8_t *)smart_arena_alloc(&smart_scratch, 512);
+    if (!sector_buffer)
+    {
+        return SMART_FS_ERROR;
+    }
     
     /* 查找空闲目录项 */
     for (uint32_t i = 0; i < 14; i++)
@@ -892,7 +932,12 @@ smart_fs_status_t smart_fs_delete(const char *filename)
             ext[i] = ext[i] - 'a' + 'A';
     }
     
-    uint8_t sector_buffer[512];
+    SMART_ARENA_SCOPE(&smart_scratch);
+    uint8_t *sector_buffer = (uint8_t *)smart_arena_alloc(&smart_scratch, 512);
+    if (!sector_buffer)
+    {
+        return SMART_FS_ERROR;
+    }
     
     /* 查找文件 */
     for (uint32_t i = 0; i < 14; i++)
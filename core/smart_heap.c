@@ -0,0 +1,453 @@
+#include "smart_heap.h"
+
+/* 块头：前一物理块指针 + 载荷大小（低位为标志）
+ * 空闲块在载荷开头额外存放空闲链表指针，因此载荷至少 8 字节
+ */
+typedef struct heap_block
+{
+    struct heap_block *prev_phys;   /* 物理上的前一块（第一块为 NULL） */
+    uint32_t size;                  /* 载荷字节数 | HEAP_BLOCK_FREE */
+    struct heap_block *next_free;   /* 仅空闲块有效 */
+    struct heap_block *prev_free;   /* 仅空闲块有效 */
+} heap_block_t;
+
+#define HEAP_BLOCK_FREE     1u
+#define HEAP_SIZE_MASK      (~(SMART_HEAP_ALIGN - 1u))
+
+#define HEAP_HDR_SIZE       offsetof(heap_block_t, next_free)
+#define HEAP_BLOCK_MIN      (sizeof(heap_block_t) - HEAP_HDR_SIZE)
+
+/* 小于 SMALL_BLOCK 的块全部放在第 0 级，按 ALIGN 线性分档 */
+#define HEAP_ALIGN_SHIFT    3
+#define HEAP_SL_COUNT       (1u << SMART_HEAP_SL_LOG2)
+#define HEAP_FL_SHIFT       (SMART_HEAP_SL_LOG2 + HEAP_ALIGN_SHIFT)
+#define HEAP_FL_COUNT       (SMART_HEAP_FL_MAX - HEAP_FL_SHIFT + 1)
+#define HEAP_SMALL_BLOCK    (1u << HEAP_FL_SHIFT)
+#define HEAP_BLOCK_MAX      ((1u << SMART_HEAP_FL_MAX) - SMART_HEAP_ALIGN)
+
+typedef struct
+{
+    uint32_t fl_bitmap;                                 /* 一级非空位图 */
+    uint32_t sl_bitmap[HEAP_FL_COUNT];                  /* 二级非空位图 */
+    heap_block_t *blocks[HEAP_FL_COUNT][HEAP_SL_COUNT]; /* 空闲链表头 */
+    
+    uint8_t *start;             /* 第一块 */
+    uint8_t *end;               /* 哨兵块（大小 0、已分配） */
+    
+    uint32_t total_bytes;
+    uint32_t free_bytes;
+    uint32_t min_free_bytes;
+    uint32_t free_blocks;
+    uint32_t used_blocks;
+    uint32_t alloc_count;
+    uint32_t fail_count;
+} heap_control_t;
+
+static heap_control_t heap;
+
+/* ========== 块操作 ========== */
+
+static uint32_t block_size(const heap_block_t *block)
+{
+    return block->size & HEAP_SIZE_MASK;
+}
+
+static int block_is_free(const heap_block_t *block)
+{
+    return (block->size & HEAP_BLOCK_FREE) != 0;
+}
+
+static void *block_to_ptr(heap_block_t *block)
+{
+    return (uint8_t *)block + HEAP_HDR_SIZE;
+}
+
+static heap_block_t *block_from_ptr(const void *ptr)
+{
+    return (heap_block_t *)((uint8_t *)ptr - HEAP_HDR_SIZE);
+}
+
+static heap_block_t *block_next(heap_block_t *block)
+{
+    return (heap_block_t *)((uint8_t *)block_to_ptr(block) + block_size(block));
+}
+
+/* ========== 分档映射 ========== */
+
+static uint32_t heap_fls(uint32_t value)
+{
+    return 31u - (uint32_t)__builtin_clz(value);
+}
+
+/* 大小 -> (fl, sl)：块插入空闲链表时使用 */
+static void mapping_insert(uint32_t size, uint32_t *fl, uint32_t *sl)
+{
+    if (size < HEAP_SMALL_BLOCK)
+    {
+        *fl = 0;
+        *sl = size / (HEAP_SMALL_BLOCK / HEAP_SL_COUNT);
+    }
+    else
+    {
+        uint32_t msb = heap_fls(size);
+        *sl = (size >> (msb - SMART_HEAP_SL_LOG2)) ^ HEAP_SL_COUNT;
+        *fl = msb - (HEAP_FL_SHIFT - 1u);
+    }
+}
+
+/* 大小 -> (fl, sl)：分配时向上取整到下一档，档内任意块都够用，无需遍历链表 */
+static void mapping_search(uint32_t size, uint32_t *fl, uint32_t *sl)
+{
+    if (size >= HEAP_SMALL_BLOCK)
+    {
+        size += (1u << (heap_fls(size) - SMART_HEAP_SL_LOG2)) - 1u;
+    }
+    mapping_insert(size, fl, sl);
+}
+
+/* 用位图找到 (fl, sl) 及以上第一个非空档 */
+static heap_block_t *search_suitable_block(uint32_t *fl, uint32_t *sl)
+{
+    if (*fl >= HEAP_FL_COUNT)
+    {
+        return NULL;
+    }
+    
+    uint32_t sl_map = heap.sl_bitmap[*fl] & (~0u << *sl);
+    if (!sl_map)
+    {
+        uint32_t fl_map = heap.fl_bitmap & (~0u << (*fl + 1u));
+        if (!fl_map)
+        {
+            return NULL;
+        }
+        
+        *fl = (uint32_t)__builtin_ctz(fl_map);
+        sl_map = heap.sl_bitmap[*fl];
+    }
+    
+    *sl = (uint32_t)__builtin_ctz(sl_map);
+    return heap.blocks[*fl][*sl];
+}
+
+static void remove_free_block(heap_block_t *block, uint32_t fl, uint32_t sl)
+{
+    heap_block_t *prev = block->prev_free;
+    heap_block_t *next = block->next_free;
+    
+    if (next) next->prev_free = prev;
+    if (prev) prev->next_free = next;
+    
+    if (heap.blocks[fl][sl] == block)
+    {
+        heap.blocks[fl][sl] = next;
+        if (!next)
+        {
+            heap.sl_bitmap[fl] &= ~(1u << sl);
+            if (!heap.sl_bitmap[fl])
+            {
+                heap.fl_bitmap &= ~(1u << fl);
+            }
+        }
+    }
+    
+    heap.free_bytes -= block_size(block);
+    heap.free_blocks--;
+}
+
+static void remove_block(heap_block_t *block)
+{
+    uint32_t fl, sl;
+    mapping_insert(block_size(block), &fl, &sl);
+    remove_free_block(block, fl, sl);
+}
+
+static void insert_block(heap_block_t *block)
+{
+    uint32_t fl, sl;
+    mapping_insert(block_size(block), &fl, &sl);
+    
+    heap_block_t *head = heap.blocks[fl][sl];
+    block->next_free = head;
+    block->prev_free = NULL;
+    if (head) head->prev_free = block;
+    
+    heap.blocks[fl][sl] = block;
+    heap.fl_bitmap |= 1u << fl;
+    heap.sl_bitmap[fl] |= 1u << sl;
+    
+    heap.free_bytes += block_size(block);
+    heap.free_blocks++;
+}
+
+/* ========== 公共接口 ========== */
+
+int smart_heap_init(void *base, size_t size)
+{
+    uintptr_t start = ((uintptr_t)base + SMART_HEAP_ALIGN - 1u) & ~(uintptr_t)(SMART_HEAP_ALIGN - 1u);
+    uintptr_t end = ((uintptr_t)base + size) & ~(uintptr_t)(SMART_HEAP_ALIGN - 1u);
+    
+    if (!base || end <= start || end - start < 2u * HEAP_HDR_SIZE + HEAP_BLOCK_MIN)
+    {
+        return -1;
+    }
+    
+    /* 第一块占据全部空间，末尾留一个哨兵块头 */
+    uint32_t payload = (uint32_t)(end - start) - 2u * HEAP_HDR_SIZE;
+    if (payload > HEAP_BLOCK_MAX)
+    {
+        payload = HEAP_BLOCK_MAX;
+    }
+    
+    SMART_HEAP_LOCK();
+    
+    for (uint32_t i = 0; i < HEAP_FL_COUNT; i++)
+    {
+        heap.sl_bitmap[i] = 0;
+        for (uint32_t j = 0; j < HEAP_SL_COUNT; j++)
+        {
+            heap.blocks[i][j] = NULL;
+        }
+    }
+    heap.fl_bitmap = 0;
+    heap.free_bytes = 0;
+    heap.free_blocks = 0;
+    heap.used_blocks = 0;
+    heap.alloc_count = 0;
+    heap.fail_count = 0;
+    
+    heap_block_t *first = (heap_block_t *)start;
+    first->prev_phys = NULL;
+    first->size = payload | HEAP_BLOCK_FREE;
+    
+    heap_block_t *sentinel = block_next(first);
+    sentinel->prev_phys = first;
+    sentinel->size = 0;
+    
+    heap.start = (uint8_t *)first;
+    heap.end = (uint8_t *)sentinel;
+    heap.total_bytes = payload;
+    
+    insert_block(first);
+    heap.min_free_bytes = heap.free_bytes;
+    
+    SMART_HEAP_UNLOCK();
+    
+    return 0;
+}
+
+void *smart_heap_alloc(size_t size)
+{
+    if (size == 0 || size > HEAP_BLOCK_MAX || !heap.start)
+    {
+        return NULL;
+    }
+    
+    uint32_t adjusted = ((uint32_t)size + SMART_HEAP_ALIGN - 1u) & HEAP_SIZE_MASK;
+    if (adjusted < HEAP_BLOCK_MIN)
+    {
+        adjusted = HEAP_BLOCK_MIN;
+    }
+    
+    uint32_t fl, sl;
+    mapping_search(adjusted, &fl, &sl);
+    
+    SMART_HEAP_LOCK();
+    
+    heap_block_t *block = search_suitable_block(&fl, &sl);
+    if (!block)
+    {
+        heap.fail_count++;
+        SMART_HEAP_UNLOCK();
+        return NULL;
+    }
+    
+    remove_free_block(block, fl, sl);
+    
+    /* 剩余部分足够组成一个块时切分出来放回空闲链表 */
+    uint32_t available = block_size(block);
+    if (available >= adjusted + HEAP_HDR_SIZE + HEAP_BLOCK_MIN)
+    {
+        heap_block_t *remain = (heap_block_t *)((uint8_t *)block_to_ptr(block) + adjusted);
+        remain->prev_phys = block;
+        remain->size = (available - adjusted - HEAP_HDR_SIZE) | HEAP_BLOCK_FREE;
+        block_next(remain)->prev_phys = remain;
+        
+        block->size = adjusted;
+        insert_block(remain);
+    }
+    else
+    {
+        block->size = available;
+    }
+    
+    heap.used_blocks++;
+    heap.alloc_count++;
+    if (heap.free_bytes < heap.min_free_bytes)
+    {
+        heap.min_free_bytes = heap.free_bytes;
+    }
+    
+    SMART_HEAP_UNLOCK();
+    
+    return block_to_ptr(block);
+}
+
+void smart_heap_free(void *ptr)
+{
+    if (!ptr)
+    {
+        return;
+    }
+    
+    uint8_t *p = (uint8_t *)ptr;
+    if (p < heap.start + HEAP_HDR_SIZE || p >= heap.end || ((uintptr_t)p & (SMART_HEAP_ALIGN - 1u)))
+    {
+        return;
+    }
+    
+    heap_block_t *block = block_from_ptr(ptr);
+    
+    SMART_HEAP_LOCK();
+    
+    /* 重复释放直接忽略 */
+    if (block_is_free(block))
+    {
+        SMART_HEAP_UNLOCK();
+        return;
+    }
+    
+    heap.used_blocks--;
+    block->size |= HEAP_BLOCK_FREE;
+    
+    /* 立即与物理相邻的空闲块合并 */
+    heap_block_t *prev = block->prev_phys;
+    if (prev && block_is_free(prev))
+    {
+        remove_block(prev);
+        prev->size += HEAP_HDR_SIZE + block_size(block);
+        block = prev;
+    }
+    
+    heap_block_t *next = block_next(block);
+    if (block_is_free(next))
+    {
+        remove_block(next);
+        block->size += HEAP_HDR_SIZE + block_size(next);
+    }
+    
+    block_next(block)->prev_phys = block;
+    insert_block(block);
+    
+    SMART_HEAP_UNLOCK();
+}
+
+size_t smart_heap_usable_size(const void *ptr)
+{
+    if (!ptr)
+    {
+        return 0;
+    }
+    
+    return block_size(block_from_ptr(ptr));
+}
+
+void smart_heap_get_stats(smart_heap_stats_t *stats)
+{
+    if (!stats)
+    {
+        return;
+    }
+    
+    SMART_HEAP_LOCK();
+    
+    stats->total_bytes = heap.total_bytes;
+    stats->free_bytes = heap.free_bytes;
+    stats->min_free_bytes = heap.min_free_bytes;
+    stats->free_blocks = heap.free_blocks;
+    stats->used_blocks = heap.used_blocks;
+    stats->alloc_count = heap.alloc_count;
+    stats->fail_count = heap.fail_count;
+    
+    /* 最大空闲块位于最高非空档，档内大小不一，需遍历该链表 */
+    stats->largest_free = 0;
+    if (heap.fl_bitmap)
+    {
+        uint32_t fl = heap_fls(heap.fl_bitmap);
+        uint32_t sl = heap_fls(heap.sl_bitmap[fl]);
+        for (heap_block_t *block = heap.blocks[fl][sl]; block; block = block->next_free)
+        {
+            if (block_size(block) > stats->largest_free)
+            {
+                stats->largest_free = block_size(block);
+            }
+        }
+    }
+    
+    SMART_HEAP_UNLOCK();
+    
+    stats->fragmentation = stats->free_bytes ?
+        100u - stats->largest_free * 100u / stats->free_bytes : 0;
+}
+
+int smart_heap_check(void)
+{
+    int result = 0;
+    uint32_t free_bytes = 0;
+    uint32_t free_blocks = 0;
+    
+    if (!heap.start)
+    {
+        return -1;
+    }
+    
+    SMART_HEAP_LOCK();
+    
+    heap_block_t *prev = NULL;
+    heap_block_t *block = (heap_block_t *)heap.start;
+    while ((uint8_t *)block < heap.end)
+    {
+        if (block->prev_phys != prev)
+        {
+            result = -2;    /* 物理链断裂 */
+            break;
+        }
+        
+        if (block_is_free(block))
+        {
+            if (prev && block_is_free(prev))
+            {
+                result = -3;    /* 相邻空闲块未合并 */
+                break;
+            }
+            
+            uint32_t fl, sl;
+            mapping_insert(block_size(block), &fl, &sl);
+            if (!(heap.sl_bitmap[fl] & (1u << sl)))
+            {
+                result = -4;    /* 位图与链表不一致 */
+                break;
+            }
+            
+            free_bytes += block_size(block);
+            free_blocks++;
+        }
+        
+        prev = block;
+        block = block_next(block);
+    }
+    
+    if (result == 0 && ((uint8_t *)block != heap.end || block->prev_phys != prev))
+    {
+        result = -5;    /* 块大小越界 */
+    }
+    
+    if (result == 0 && (free_bytes != heap.free_bytes || free_blocks != heap.free_blocks))
+    {
+        result = -6;    /* 统计不一致 */
+    }
+    
+    SMART_HEAP_UNLOCK();
+    
+    return result;
+}
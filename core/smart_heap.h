@@ -0,0 +1,58 @@
+#ifndef __SMART_HEAP_H__
+#define __SMART_HEAP_H__
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* TLSF（Two-Level Segregated Fit）实时堆
+ * 一级按 2 的幂分档、二级再细分 SMART_HEAP_SL_COUNT 档，两级位图 + CLZ/CTZ
+ * 在常数步内找到合适的空闲块；释放时立即与前后相邻空闲块合并。
+ * 分配与释放的最坏执行时间与堆大小和碎片程度无关，可在周期任务中调用。
+ * 堆区域为 link.lds 中的 .heap 输出段（_sheap/_eheap），占用程序 RAM 中其余各段之外的全部空间。
+ */
+
+/* 加锁方式：默认使用内核临界区（BASEPRI 上限以下的中断中也可调用）
+ * 需要替换为其他锁（如仅任务上下文使用的互斥锁）时在编译选项中重定义
+ */
+#ifndef SMART_HEAP_LOCK
+#include "smart_core.h"
+#define SMART_HEAP_LOCK()    smart_enter_critical()
+#define SMART_HEAP_UNLOCK()  smart_exit_critical()
+#endif
+
+#define SMART_HEAP_ALIGN        8u      /* 载荷对齐 */
+#define SMART_HEAP_SL_LOG2      3       /* 二级分档数 = 8 */
+#define SMART_HEAP_FL_MAX       15      /* 最大块 < 2^15 (32KB) */
+
+/* 堆统计 */
+typedef struct {
+    uint32_t total_bytes;       /* 可分配总字节数（扣除管理开销后） */
+    uint32_t free_bytes;        /* 空闲载荷字节数 */
+    uint32_t min_free_bytes;    /* 空闲字节历史最低值 */
+    uint32_t largest_free;      /* 最大空闲块 */
+    uint32_t free_blocks;       /* 空闲块数 */
+    uint32_t used_blocks;       /* 已分配块数 */
+    uint32_t alloc_count;       /* 分配成功次数 */
+    uint32_t fail_count;        /* 分配失败次数 */
+    uint32_t fragmentation;     /* 碎片率（%）= 100 - 最大空闲块 / 空闲总量 */
+} smart_heap_stats_t;
+
+/* 用一段内存初始化堆，成功返回 0 */
+int smart_heap_init(void *base, size_t size);
+
+/* 分配 size 字节（SMART_HEAP_ALIGN 对齐），失败返回 NULL */
+void *smart_heap_alloc(size_t size);
+
+/* 释放，ptr 为 NULL 时忽略 */
+void smart_heap_free(void *ptr);
+
+/* 查询 ptr 所在块的可用字节数 */
+size_t smart_heap_usable_size(const void *ptr);
+
+/* 读取统计（最大空闲块需要遍历一个分档链表，不要在实时路径上调用） */
+void smart_heap_get_stats(smart_heap_stats_t *stats);
+
+/* 一致性检查（遍历全部物理块，用于测试），正常返回 0 */
+int smart_heap_check(void);
+
+#endif
@@ -0,0 +1,154 @@
+#include "smart_malloc.h"
+#include "smart_core.h"
+#include "smart_atomic.h"
+#include "smart_memmap.h"
+
+#define MALLOC_CLASS_SIZE(i)  (1u << (SMART_MALLOC_MIN_SHIFT + (i)))
+
+#define MALLOC_ARENA_SIZE  (SMART_MEMPOOL_BUFFER_SIZE(MALLOC_CLASS_SIZE(0), SMART_MALLOC_BLOCKS_0) + \
+                            SMART_MEMPOOL_BUFFER_SIZE(MALLOC_CLASS_SIZE(1), SMART_MALLOC_BLOCKS_1) + \
+                            SMART_MEMPOOL_BUFFER_SIZE(MALLOC_CLASS_SIZE(2), SMART_MALLOC_BLOCKS_2) + \
+                            SMART_MEMPOOL_BUFFER_SIZE(MALLOC_CLASS_SIZE(3), SMART_MALLOC_BLOCKS_3))
+
+static const uint16_t class_blocks[SMART_MALLOC_CLASSES] = {
+    SMART_MALLOC_BLOCKS_0,
+    SMART_MALLOC_BLOCKS_1,
+    SMART_MALLOC_BLOCKS_2,
+    SMART_MALLOC_BLOCKS_3
+};
+
+static const char *const class_names[SMART_MALLOC_CLASSES] = {
+    "malloc-16",
+    "malloc-32",
+    "malloc-64",
+    "malloc-128"
+};
+
+/* 各级内存池按大小递增依次排列在 malloc_arena 中 */
+static uint8_t malloc_arena[MALLOC_ARENA_SIZE] SMART_SECTION_POOL;
+static smart_mempool_t class_pools[SMART_MALLOC_CLASSES];
+
+/* 统计计数器（原子更新，分配路径不额外关中断） */
+static volatile uint32_t class_alloc_count[SMART_MALLOC_CLASSES];
+static volatile uint32_t class_spill_count[SMART_MALLOC_CLASSES];
+static volatile uint32_t class_fail_count[SMART_MALLOC_CLASSES];
+
+/* 大小 -> 级别：向上取整到 2 的幂 */
+static uint32_t smart_malloc_class_of_size(size_t size)
+{
+    if (size <= MALLOC_CLASS_SIZE(0))
+    {
+        return 0;
+    }
+    
+    return 32u - (uint32_t)__builtin_clz((uint32_t)size - 1u) - SMART_MALLOC_MIN_SHIFT;
+}
+
+/* 地址 -> 级别：各级内存池地址连续递增，比较上界即可 */
+static int smart_malloc_class_of_ptr(const void *ptr)
+{
+    const uint8_t *p = (const uint8_t *)ptr;
+    
+    if (p < malloc_arena || p >= malloc_arena + MALLOC_ARENA_SIZE)
+    {
+        return -1;
+    }
+    
+    for (int i = 0; i < SMART_MALLOC_CLASSES; i++)
+    {
+        if (p < class_pools[i].buffer_end)
+        {
+            return i;
+        }
+    }
+    
+    return -1;
+}
+
+void smart_malloc_init(void)
+{
+    uint8_t *cursor = malloc_arena;
+    
+    for (uint32_t i = 0; i < SMART_MALLOC_CLASSES; i++)
+    {
+        /* 不限流 */
+        smart_mempool_init(&class_pools[i], cursor, MALLOC_CLASS_SIZE(i), class_blocks[i], 0);
+        smart_mempool_set_name(&class_pools[i], class_names[i]);
+        cursor += SMART_MEMPOOL_BUFFER_SIZE(MALLOC_CLASS_SIZE(i), class_blocks[i]);
+        
+        class_alloc_count[i] = 0;
+        class_spill_count[i] = 0;
+        class_fail_count[i] = 0;
+    }
+}
+
+void *smart_malloc(size_t size)
+{
+    if (size == 0 || size > SMART_MALLOC_MAX_SIZE)
+    {
+        return NULL;
+    }
+    
+    uint32_t first = smart_malloc_class_of_size(size);
+    
+    for (uint32_t i = first; i < SMART_MALLOC_CLASSES; i++)
+    {
+        void *block = NULL;
+        if (smart_mempool_alloc_try(&class_pools[i], &block) == SMART_MEMPOOL_OK)
+        {
+            smart_atomic_inc(&class_alloc_count[i]);
+            /* 首选级别耗尽、由更大级别满足时才计为溢出；全部失败记入 fail */
+            if (i != first)
+            {
+                smart_atomic_inc(&class_spill_count[first]);
+            }
+            return block;
+        }
+    }
+    
+    smart_atomic_inc(&class_fail_count[first]);
+    return NULL;
+}
+
+void smart_free(void *ptr)
+{
+    if (!ptr)
+    {
+        return;
+    }
+    
+    int index = smart_malloc_class_of_ptr(ptr);
+    if (index < 0)
+    {
+        return;
+    }
+    
+    smart_mempool_free_try(&class_pools[index], ptr);
+}
+
+size_t smart_malloc_usable_size(const void *ptr)
+{
+    int index = smart_malloc_class_of_ptr(ptr);
+    return (index < 0) ? 0 : MALLOC_CLASS_SIZE(index);
+}
+
+int smart_malloc_get_class_stats(uint32_t class_index, smart_malloc_class_stats_t *stats)
+{
+    if (class_index >= SMART_MALLOC_CLASSES || !stats)
+    {
+        return -1;
+    }
+    
+    smart_mempool_stats_t pool_stats;
+    smart_mempool_get_stats(&class_pools[class_index], &pool_stats);
+    
+    stats->block_size = pool_stats.block_size;
+    stats->block_count = pool_stats.block_count;
+    stats->free_count = pool_stats.free_count;
+    stats->min_free_count = pool_stats.min_free_count;
+    stats->alloc_count = class_alloc_count[class_index];
+    stats->spill_count = class_spill_count[class_index];
+    stats->fail_count = class_fail_count[class_index];
+    
+    return 0;
+}
@@ -0,0 +1,59 @@
+#ifndef __SMART_MALLOC_H__
+#define __SMART_MALLOC_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include "smart_mempool.h"
+
+/* 分级内存分配器：按 2 的幂大小分级，每级一个 smart_mempool_t
+ * 各级内存池在同一块连续内存中依次排列，释放时按地址范围确定所属级别，
+ * 块内不需要额外头部；分配和释放都是 O(1)（级数固定）。
+ * 某一级耗尽时依次尝试更大的级别。
+ */
+
+#define SMART_MALLOC_MIN_SHIFT  4   /* 最小块 16 字节 */
+#define SMART_MALLOC_CLASSES    4   /* 16/32/64/128 字节 */
+
+/* 每级块数 */
+#ifndef SMART_MALLOC_BLOCKS_0
+#define SMART_MALLOC_BLOCKS_0   16
+#endif
+#ifndef SMART_MALLOC_BLOCKS_1
+#define SMART_MALLOC_BLOCKS_1   8
+#endif
+#ifndef SMART_MALLOC_BLOCKS_2
+#define SMART_MALLOC_BLOCKS_2   6
+#endif
+#ifndef SMART_MALLOC_BLOCKS_3
+#define SMART_MALLOC_BLOCKS_3   4
+#endif
+
+#define SMART_MALLOC_MAX_SIZE   (1u << (SMART_MALLOC_MIN_SHIFT + SMART_MALLOC_CLASSES - 1))
+
+/* 每级统计 */
+typedef struct {
+    uint32_t block_size;
+    uint16_t block_count;
+    uint16_t free_count;
+    uint16_t min_free_count;
+    uint32_t alloc_count;       /* 由本级满足的分配次数 */
+    uint32_t spill_count;       /* 本级耗尽、改用更大级别的次数 */
+    uint32_t fail_count;        /* 本级及更大级别都无法满足的次数 */
+} smart_malloc_class_stats_t;
+
+/* 初始化（在创建任务前调用一次） */
+void smart_malloc_init(void);
+
+/* 分配 size 字节（不超过 SMART_MALLOC_MAX_SIZE），失败返回 NULL */
+void *smart_malloc(size_t size);
+
+/* 释放，ptr 为 NULL 时忽略 */
+void smart_free(void *ptr);
+
+/* 查询 ptr 所在块的可用字节数，非本分配器地址返回 0 */
+size_t smart_malloc_usable_size(const void *ptr);
+
+/* 读取第 class_index 级的统计，成功返回 0 */
+int smart_malloc_get_class_stats(uint32_t class_index, smart_malloc_class_stats_t *stats);
+
+#endif
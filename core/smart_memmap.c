@@ -0,0 +1,129 @@
+#include "smart_memmap.h"
+#include "smart_heap.h"
+#include "smart_uart.h"
+#include <string.h>
+
+#define MSP_FILL_PATTERN  0xA5A5A5A5u
+#define MSP_FILL_MARGIN   64u   /* 填充时在当前栈指针下方留出的余量 */
+
+/* 链接脚本导出的段边界 */
+extern uint8_t _sdata[], _edata[];
+extern uint8_t _sbss[], _ebss[];
+extern uint8_t _sstacks[], _estacks[];
+extern uint8_t _spools[], _epools[];
+extern uint8_t _sheap[], _eheap[];
+extern uint8_t _smsp[], _estack[];
+extern uint8_t __stacks_limit[], __pools_limit[], __msp_stack_size[];
+#ifdef QEMU_ENV
+extern uint8_t _sfs_ram[], _efs_ram[];
+#else
+extern uint8_t _sfs_flash[], _efs_flash[];
+#endif
+
+static int msp_filled = 0;
+
+void smart_memmap_init(void)
+{
+    uint32_t sp;
+    __asm volatile ("MRS %0, MSP" : "=r" (sp));
+    
+    /* 只填充当前栈指针以下的部分，之上是 main() 已在使用的栈帧 */
+    uint32_t *p = (uint32_t *)_smsp;
+    uint32_t *end = (uint32_t *)((sp - MSP_FILL_MARGIN) & ~3u);
+    while (p < end)
+    {
+        *p++ = MSP_FILL_PATTERN;
+    }
+    msp_filled = 1;
+}
+
+/* 主栈最深使用量：从底部向上找到第一个被改写的字 */
+static uint32_t smart_memmap_msp_used(void)
+{
+    if (!msp_filled)
+    {
+        return 0;
+    }
+    
+    const uint32_t *p = (const uint32_t *)_smsp;
+    const uint32_t *top = (const uint32_t *)_estack;
+    while (p < top && *p == MSP_FILL_PATTERN)
+    {
+        p++;
+    }
+    return (uint32_t)((const uint8_t *)top - (const uint8_t *)p);
+}
+
+static uint32_t smart_memmap_add(smart_memregion_t *regions, uint32_t count, uint32_t max_regions,
+                                 const char *name, const uint8_t *start, const uint8_t *end,
+                                 uint32_t limit, uint32_t used)
+{
+    if (count >= max_regions)
+    {
+        return count;
+    }
+    
+    regions[count].name = name;
+    regions[count].start = (uint32_t)start;
+    regions[count].size = (uint32_t)(end - start);
+    regions[count].limit = limit;
+    regions[count].used = used;
+    return count + 1;
+}
+
+uint32_t smart_memmap_get(smart_memregion_t *regions, uint32_t max_regions)
+{
+    if (!regions)
+    {
+        return 0;
+    }
+    
+    smart_heap_stats_t heap_stats;
+    smart_heap_get_stats(&heap_stats);
+    
+    uint32_t n = 0;
+    n = smart_memmap_add(regions, n, max_regions, ".data", _sdata, _edata,
+                         0, (uint32_t)(_edata - _sdata));
+    n = smart_memmap_add(regions, n, max_regions, ".bss", _sbss, _ebss,
+                         0, (uint32_t)(_ebss - _sbss));
+    n = smart_memmap_add(regions, n, max_regions, ".stacks", _sstacks, _estacks,
+                         (uint32_t)__stacks_limit, (uint32_t)(_estacks - _sstacks));
+    n = smart_memmap_add(regions, n, max_regions, ".pools", _spools, _epools,
+                         (uint32_t)__pools_limit, (uint32_t)(_epools - _spools));
+    n = smart_memmap_add(regions, n, max_regions, ".heap", _sheap, _eheap,
+                         0, heap_stats.total_bytes - heap_stats.free_bytes);
+    n = smart_memmap_add(regions, n, max_regions, ".msp_stack", _smsp, _estack,
+                         (uint32_t)__msp_stack_size, smart_memmap_msp_used());
+#ifdef QEMU_ENV
+    n = smart_memmap_add(regions, n, max_regions, ".fs_ram", _sfs_ram, _efs_ram,
+                         0, 0);
+#else
+    n = smart_memmap_add(regions, n, max_regions, "fs_flash", _sfs_flash, _efs_flash,
+                         0, 0);
+#endif
+    return n;
+}
+
+void smart_memmap_print(void)
+{
+    smart_memregion_t regions[8];
+    uint32_t count = smart_memmap_get(regions, 8);
+    
+    smart_uart_print("[MemMap] Region      Start     Size      Limit\n");
+    for (uint32_t i = 0; i < count; i++)
+    {
+        smart_uart_print("[MemMap] ");
+        smart_uart_print(regions[i].name);
+        for (size_t pad = strlen(regions[i].name); pad < 10; pad++)
+        {
+            smart_uart_print(" ");
+        }
+        smart_uart_print("  ");
+        smart_uart_print_hex32(regions[i].start);
+        smart_uart_print("  ");
+        smart_uart_print_hex32(regions[i].size);
+        smart_uart_print("  ");
+        smart_uart_print_hex32(regions[i].limit);
+        smart_uart_print("\n");
+    }
+}
@@ -0,0 +1,38 @@
+#ifndef __SMART_MEMMAP_H__
+#define __SMART_MEMMAP_H__
+
+#include <stdint.h>
+
+/* 内存布局：RAM 按用途划分为链接脚本中的具名段（见 link.lds）
+ *   .data/.bss   内核与驱动的全局数据
+ *   .stacks      任务栈（SMART_SECTION_STACK）
+ *   .pools       内存池、分配器与临时区域的后备数组（SMART_SECTION_POOL）
+ *   .heap        TLSF 堆，占用其余全部空间
+ *   .msp_stack   主栈（main() 与中断）
+ *   .fs_ram      QEMU 下的文件系统存储（独立的 FSRAM 区）
+ * 各段的预算在链接时用 ASSERT 检查，超出即链接失败。
+ */
+
+/* 放入任务栈段 / 内存池段（不清零，由使用者初始化） */
+#define SMART_SECTION_STACK  __attribute__((section(".stacks"), aligned(8)))
+#define SMART_SECTION_POOL   __attribute__((section(".pools"), aligned(8)))
+
+typedef struct
+{
+    const char *name;
+    uint32_t start;
+    uint32_t size;      /* 段实际大小 */
+    uint32_t limit;     /* 链接脚本中的预算，0 表示由剩余空间决定 */
+    uint32_t used;      /* 运行时使用量（堆为已分配字节，主栈为历史最深位置） */
+} smart_memregion_t;
+
+/* 在 main() 开头调用：填充主栈未使用部分，用于统计主栈最大深度 */
+void smart_memmap_init(void);
+
+/* 读取各段信息，返回写入的条目数 */
+uint32_t smart_memmap_get(smart_memregion_t *regions, uint32_t max_regions);
+
+/* 打印内存布局 */
+void smart_memmap_print(void);
+
+#endif
@@ -1,73 +1,501 @@
 #include "smart_mempool.h"
 #include "smart_core.h"
 #include "smart_uart.h"
+#include "smart_atomic.h"
+#include <string.h>
 
-#ifndef SMART_MEMPOOL_MAX_POOLS
-#define SMART_MEMPOOL_MAX_POOLS 4
-#endif
+/* 已注册的内存池（侵入式链表，数量不限） */
+static smart_mempool_t *mempool_registry = NULL;
 
-static smart_mempool_t *pool_registry[SMART_MEMPOOL_MAX_POOLS];
-static uint32_t pool_registry_count = 0;
+/* 空闲栈顶字：低 16 位为块索引，高 16 位为版本号，每次修改加 1 防止 ABA */
+#define MEMPOOL_INDEX_MASK   0xFFFFu
+#define MEMPOOL_INDEX_NONE   0xFFFFu
+#define MEMPOOL_HEAD(old, index)  ((((old) + 0x10000u) & ~MEMPOOL_INDEX_MASK) | (index))
 
-static uint32_t align_up(uint32_t value, uint32_t align)
+/* 选择当前上下文使用的令牌桶（在临界区内调用） */
+static smart_mempool_bucket_t *smart_mempool_bucket(smart_mempool_t *pool, smart_time_t now)
 {
-    return (value + (align - 1u)) & ~(align - 1u);
+    smart_mempool_bucket_t *shared = &pool->buckets[SMART_MEMPOOL_TASK_BUCKETS];
+    smart_task_t current = smart_get_current_task();
+    if (!current || smart_in_isr())
+    {
+        return shared;
+    }
+    
+    smart_mempool_bucket_t *spare = NULL;
+    for (uint32_t i = 0; i < SMART_MEMPOOL_TASK_BUCKETS; ++i)
+    {
+        smart_mempool_bucket_t *bucket = &pool->buckets[i];
+        if (bucket->owner == current)
+        {
+            return bucket;
+        }
+        
+        /* 空闲桶，或闲置到令牌已经补满的桶，可以转给新任务 */
+        if (!spare && (!bucket->owner ||
+                       now - bucket->last >= SMART_MEMPOOL_BURST_TICKS))
+        {
+            spare = bucket;
+        }
+    }
+    
+    if (!spare)
+    {
+        return shared;
+    }
+    
+    spare->owner = current;
+    spare->last = now;
+    spare->tokens = (uint16_t)(pool->ops_per_tick * SMART_MEMPOOL_BURST_TICKS);
+    return spare;
 }
 
-static int smart_mempool_register(smart_mempool_t *pool)
+/* 按距上次补充经过的 tick 数补充令牌，然后消耗一个，令牌不足返回 0 */
+static int smart_mempool_take_token(smart_mempool_t *pool)
 {
-    if (pool_registry_count >= SMART_MEMPOOL_MAX_POOLS)
+    smart_time_t now = smart_get_tick();
+    smart_mempool_bucket_t *bucket = smart_mempool_bucket(pool, now);
+    uint32_t capacity = (uint32_t)pool->ops_per_tick * SMART_MEMPOOL_BURST_TICKS;
+    smart_time_t elapsed = now - bucket->last;
+    
+    if (elapsed >= SMART_MEMPOOL_BURST_TICKS)
     {
-        return -1;
+        bucket->tokens = (uint16_t)capacity;
     }
-    pool_registry[pool_registry_count++] = pool;
-    return 0;
+    else if (elapsed != 0)
+    {
+        uint32_t tokens = bucket->tokens + elapsed * pool->ops_per_tick;
+        bucket->tokens = (uint16_t)((tokens > capacity) ? capacity : tokens);
+    }
+    bucket->last = now;
+    
+    if (bucket->tokens == 0)
+    {
+        return 0;
+    }
+    bucket->tokens--;
+    return 1;
 }
 
-static int smart_mempool_address_valid(smart_mempool_t *pool, void *block)
+/* 限流池在临界区内取令牌，不限流的池直接通过 */
+static int smart_mempool_acquire(smart_mempool_t *pool)
 {
-    if (!pool || !block) return 0;
+    if (pool->ops_per_tick == 0)
+    {
+        return 1;
+    }
     
-    uint8_t *ptr = (uint8_t *)block;
+    smart_enter_critical();
+    int ok = smart_mempool_take_token(pool);
+    smart_exit_critical();
+    return ok;
+}
+
+/* 校验块地址并换算为索引：范围检查 + 倒数乘法，无除法 */
+static int smart_mempool_block_index(const smart_mempool_t *pool, const void *block,
+                                     uint32_t *index)
+{
+    const uint8_t *ptr = (const uint8_t *)block;
     if (ptr < pool->buffer || ptr >= pool->buffer_end) return 0;
-    if (((uintptr_t)(ptr - pool->buffer)) % pool->block_stride != 0) return 0;
+    
+    uint32_t offset = (uint32_t)(ptr - pool->buffer);
+    uint32_t i = (uint32_t)(((uint64_t)offset * pool->stride_recip) >> 32);
+    if (i * pool->block_stride != offset) return 0;
+    
+    *index = i;
     return 1;
 }
 
-void smart_mempool_init(smart_mempool_t *pool,
-                        void *buffer,
-                        uint32_t block_size,
-                        uint32_t block_count,
-                        uint16_t ops_per_tick)
+static int smart_mempool_is_empty(const smart_mempool_t *pool)
 {
-    if (!pool || !buffer || block_size == 0 || block_count == 0)
+    return (pool->free_head & MEMPOOL_INDEX_MASK) == MEMPOOL_INDEX_NONE;
+}
+
+static void smart_mempool_track_min(smart_mempool_t *pool, uint32_t free_count)
+{
+    uint32_t min;
+    do {
+        min = pool->min_free_count;
+        if (free_count >= min)
+        {
+            return;
+        }
+    } while (!smart_atomic_cas(&pool->min_free_count, min, free_count));
+}
+
+/* 从空闲栈弹出一块，空时返回 NULL */
+static void *smart_mempool_pop(smart_mempool_t *pool)
+{
+    uint32_t head;
+    uint32_t next;
+    uint8_t *block;
+    
+    do {
+        head = pool->free_head;
+        if ((head & MEMPOOL_INDEX_MASK) == MEMPOOL_INDEX_NONE)
+        {
+            return NULL;
+        }
+        block = pool->buffer + (head & MEMPOOL_INDEX_MASK) * pool->block_stride;
+        /* 块可能刚被其他上下文弹出并改写，此时版本号已变，CAS 失败后重读 */
+        next = *(volatile uint32_t *)block & MEMPOOL_INDEX_MASK;
+    } while (!smart_atomic_cas(&pool->free_head, head, MEMPOOL_HEAD(head, next)));
+    
+    smart_mempool_track_min(pool, smart_atomic_dec(&pool->free_count));
+    return block;
+}
+
+/* 压入空闲栈（计数先加，保证 free_count 不小于栈中块数） */
+static void smart_mempool_push(smart_mempool_t *pool, void *block, uint32_t index)
+{
+    uint32_t head;
+    
+    smart_atomic_inc(&pool->free_count);
+    do {
+        head = pool->free_head;
+        *(volatile uint32_t *)block = head & MEMPOOL_INDEX_MASK;
+    } while (!smart_atomic_cas(&pool->free_head, head, MEMPOOL_HEAD(head, index)));
+}
+
+#if SMART_MEMPOOL_DEBUG
+
+#define MEMPOOL_STATE_FREE   0xF4EEB10Cu
+#define MEMPOOL_STATE_ALLOC  0xA110CA7Eu
+
+static smart_mempool_trailer_t *smart_mempool_trailer(const smart_mempool_t *pool,
+                                                      const uint8_t *block)
+{
+    return (smart_mempool_trailer_t *)(block + pool->block_stride -
+                                       sizeof(smart_mempool_trailer_t));
+}
+
+/* 红区：从载荷末尾（含对齐填充）到尾部记录之前 */
+static uint8_t *smart_mempool_redzone(const smart_mempool_t *pool, uint8_t *block,
+                                      uint32_t *len)
+{
+    *len = pool->block_stride - sizeof(smart_mempool_trailer_t) - pool->block_size;
+    return block + pool->block_size;
+}
+
+static int smart_mempool_fill_check(const uint8_t *p, uint32_t len, uint8_t value)
+{
+    for (uint32_t i = 0; i < len; i++)
     {
-        return;
+        if (p[i] != value)
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static void smart_mempool_debug_report(const char *what, const smart_mempool_t *pool,
+                                       const void *block, const smart_mempool_trailer_t *trailer)
+{
+    smart_uart_print("[Mempool] ");
+    smart_uart_print(what);
+    smart_uart_print(": block 0x");
+    smart_uart_print_hex32((uint32_t)block);
+    smart_uart_print(" pool 0x");
+    smart_uart_print_hex32((uint32_t)pool);
+    if (trailer)
+    {
+        smart_uart_print(" owner 0x");
+        smart_uart_print_hex32((uint32_t)trailer->owner);
+        smart_uart_print(" tick 0x");
+        smart_uart_print_hex32(trailer->tick);
+    }
+    smart_uart_print("\n");
+}
+
+/* 初始化时把所有块标记为空闲并毒化（首字为空闲链接，不毒化） */
+static void smart_mempool_debug_init(smart_mempool_t *pool)
+{
+    for (uint32_t i = 0; i < pool->block_count; ++i)
+    {
+        uint8_t *block = pool->buffer + i * pool->block_stride;
+        memset(block + 4, SMART_MEMPOOL_POISON_BYTE, pool->block_size > 4 ? pool->block_size - 4 : 0);
+        smart_mempool_trailer_t *trailer = smart_mempool_trailer(pool, block);
+        trailer->owner = NULL;
+        trailer->tick = 0;
+        trailer->state = MEMPOOL_STATE_FREE;
+    }
+}
+
+/* 块离开空闲栈：检查释放后写入，记录分配者，填充红区 */
+static void smart_mempool_debug_alloc(smart_mempool_t *pool, uint8_t *block, smart_task_t owner)
+{
+    smart_mempool_trailer_t *trailer = smart_mempool_trailer(pool, block);
+    
+    if (pool->block_size > 4 &&
+        !smart_mempool_fill_check(block + 4, pool->block_size - 4, SMART_MEMPOOL_POISON_BYTE))
+    {
+        smart_mempool_debug_report("write after free", pool, block, trailer);
+    }
+    
+    uint32_t len;
+    uint8_t *redzone = smart_mempool_redzone(pool, block, &len);
+    memset(redzone, SMART_MEMPOOL_REDZONE_BYTE, len);
+    
+    trailer->owner = owner;
+    trailer->tick = smart_get_tick();
+    trailer->state = MEMPOOL_STATE_ALLOC;
+}
+
+/* 块归还前：检测重复释放与越界写，然后毒化。重复释放返回 0，块不得入栈 */
+static int smart_mempool_debug_free(smart_mempool_t *pool, uint8_t *block)
+{
+    smart_mempool_trailer_t *trailer = smart_mempool_trailer(pool, block);
+    
+    if (!smart_atomic_cas(&trailer->state, MEMPOOL_STATE_ALLOC, MEMPOOL_STATE_FREE))
+    {
+        smart_mempool_debug_report((trailer->state == MEMPOOL_STATE_FREE) ?
+                                   "double free" : "corrupted trailer",
+                                   pool, block, trailer);
+        return 0;
+    }
+    
+    uint32_t len;
+    uint8_t *redzone = smart_mempool_redzone(pool, block, &len);
+    if (!smart_mempool_fill_check(redzone, len, SMART_MEMPOOL_REDZONE_BYTE))
+    {
+        smart_mempool_debug_report("redzone overwritten", pool, block, trailer);
+    }
+    
+    memset(block, SMART_MEMPOOL_POISON_BYTE, pool->block_size);
+    return 1;
+}
+
+/* owner 在 (pool, index) 之前是否已出现过（用于按任务分组输出） */
+static int smart_mempool_debug_owner_seen(const smart_mempool_t *pool, uint32_t index,
+                                          smart_task_t owner)
+{
+    for (const smart_mempool_t *p = mempool_registry; p; p = p->next_registered)
+    {
+        uint32_t end = (p == pool) ? index : p->block_count;
+        for (uint32_t i = 0; i < end; ++i)
+        {
+            const smart_mempool_trailer_t *t =
+                smart_mempool_trailer(p, p->buffer + i * p->block_stride);
+            if (t->state == MEMPOOL_STATE_ALLOC && t->owner == owner)
+            {
+                return 1;
+            }
+        }
+        if (p == pool)
+        {
+            break;
+        }
+    }
+    return 0;
+}
+
+void smart_mempool_debug_dump(void)
+{
+    smart_time_t now = smart_get_tick();
+    uint32_t total = 0;
+    
+    for (smart_mempool_t *pool = mempool_registry; pool; pool = pool->next_registered)
+    {
+        for (uint32_t i = 0; i < pool->block_count; ++i)
+        {
+            smart_mempool_trailer_t *trailer =
+                smart_mempool_trailer(pool, pool->buffer + i * pool->block_stride);
+            if (trailer->state != MEMPOOL_STATE_ALLOC ||
+                smart_mempool_debug_owner_seen(pool, i, trailer->owner))
+            {
+                continue;
+            }
+            
+            smart_task_t owner = trailer->owner;
+            smart_uart_print("Task 0x");
+            smart_uart_print_hex32((uint32_t)owner);
+            if (owner)
+            {
+                smart_uart_print(" (entry 0x");
+                smart_uart_print_hex32((uint32_t)owner->entry);
+                smart_uart_print(")\n");
+            }
+            else
+            {
+                smart_uart_print(" (ISR)\n");
+            }
+            
+            /* 从当前位置起输出该任务持有的全部块 */
+            uint32_t count = 0;
+            for (smart_mempool_t *p = pool; p; p = p->next_registered)
+            {
+                for (uint32_t j = (p == pool) ? i : 0; j < p->block_count; ++j)
+                {
+                    uint8_t *block = p->buffer + j * p->block_stride;
+                    smart_mempool_trailer_t *t = smart_mempool_trailer(p, block);
+                    if (t->state != MEMPOOL_STATE_ALLOC || t->owner != owner)
+                    {
+                        continue;
+                    }
+                    
+                    uint32_t len;
+                    uint8_t *redzone = smart_mempool_redzone(p, block, &len);
+                    smart_uart_print("  0x");
+                    smart_uart_print_hex32((uint32_t)block);
+                    smart_uart_print(" size 0x");
+                    smart_uart_print_hex32(p->block_size);
+                    smart_uart_print(" age 0x");
+                    smart_uart_print_hex32(now - t->tick);
+                    smart_uart_print(smart_mempool_fill_check(redzone, len, SMART_MEMPOOL_REDZONE_BYTE) ?
+                                     "\n" : " REDZONE!\n");
+                    count++;
+                }
+            }
+            
+            smart_uart_print("  blocks: 0x");
+            smart_uart_print_hex32(count);
+            smart_uart_print("\n");
+            total += count;
+        }
+    }
+    
+    smart_uart_print("Outstanding blocks: 0x");
+    smart_uart_print_hex32(total);
+    smart_uart_print("\n");
+}
+
+#endif
+
+smart_mempool_status_t smart_mempool_init(smart_mempool_t *pool,
+                                          void *buffer,
+                                          uint32_t block_size,
+                                          uint32_t block_count,
+                                          uint16_t ops_per_tick)
+{
+    if (!pool || !buffer || block_size == 0 || block_count == 0 ||
+        block_count > SMART_MEMPOOL_MAX_BLOCKS)
+    {
+        return SMART_MEMPOOL_INVALID;
     }
     
     smart_enter_critical();
     
+    /* 已注册的池可能有等待者和未归还的块，重建空闲链表会使它们失效；需先 deinit */
+    for (const smart_mempool_t *node = mempool_registry; node; node = node->next_registered)
+    {
+        if (node == pool)
+        {
+            smart_exit_critical();
+            return SMART_MEMPOOL_BUSY;
+        }
+    }
+    
     pool->buffer = (uint8_t *)buffer;
-    pool->block_stride = align_up(block_size, 4u);
+    pool->block_stride = SMART_MEMPOOL_STRIDE(block_size);
+    pool->stride_recip = 0xFFFFFFFFu / pool->block_stride + 1u;
     pool->block_size = block_size;
     pool->block_count = (uint16_t)block_count;
     pool->buffer_end = pool->buffer + pool->block_stride * block_count;
-    pool->free_count = (uint16_t)block_count;
-    pool->min_free_count = (uint16_t)block_count;
-    pool->ops_per_tick = (ops_per_tick == 0) ? (uint16_t)block_count : ops_per_tick;
-    pool->ops_left = pool->ops_per_tick;
+    pool->free_count = block_count;
+    pool->min_free_count = block_count;
+    pool->wait_list = NULL;
+    
+    /* 桶容量需放进 uint16_t */
+    if ((uint32_t)ops_per_tick * SMART_MEMPOOL_BURST_TICKS > 0xFFFFu)
+    {
+        ops_per_tick = (uint16_t)(0xFFFFu / SMART_MEMPOOL_BURST_TICKS);
+    }
+    pool->ops_per_tick = ops_per_tick;
     
-    pool->free_list = pool->buffer;
+    /* 所有桶初始为满 */
+    smart_time_t now = smart_get_tick();
+    for (uint32_t i = 0; i <= SMART_MEMPOOL_TASK_BUCKETS; ++i)
+    {
+        pool->buckets[i].owner = NULL;
+        pool->buckets[i].last = now;
+        pool->buckets[i].tokens = (uint16_t)(ops_per_tick * SMART_MEMPOOL_BURST_TICKS);
+    }
+    
+    /* 空闲栈按索引链接：块 i 的首字存放下一块的索引 */
+    pool->free_head = 0;
     for (uint32_t i = 0; i < block_count; ++i)
     {
         uint8_t *current = pool->buffer + i * pool->block_stride;
-        uint8_t *next = (i + 1u < block_count) ? (current + pool->block_stride) : NULL;
-        *(void **)current = next;
+        *(uint32_t *)current = (i + 1u < block_count) ? (i + 1u) : MEMPOOL_INDEX_NONE;
     }
     
-    smart_mempool_register(pool);
+#if SMART_MEMPOOL_DEBUG
+    smart_mempool_debug_init(pool);
+#endif
+    
+    pool->name = NULL;
+    pool->next_registered = mempool_registry;
+    mempool_registry = pool;
     
     smart_exit_critical();
+    return SMART_MEMPOOL_OK;
+}
+
+smart_mempool_status_t smart_mempool_deinit(smart_mempool_t *pool)
+{
+    if (!pool)
+    {
+        return SMART_MEMPOOL_INVALID;
+    }
+    
+    smart_enter_critical();
+    
+    if (pool->wait_list != NULL || pool->free_count != pool->block_count)
+    {
+        smart_exit_critical();
+        return SMART_MEMPOOL_BUSY;
+    }
+    
+    smart_mempool_t **link = &mempool_registry;
+    while (*link && *link != pool)
+    {
+        link = &(*link)->next_registered;
+    }
+    if (*link)
+    {
+        *link = pool->next_registered;
+    }
+    pool->next_registered = NULL;
+    pool->name = NULL;
+    
+    /* 之后的分配返回 EMPTY，释放返回 INVALID */
+    pool->free_head = MEMPOOL_INDEX_NONE;
+    pool->free_count = 0;
+    pool->min_free_count = 0;
+    pool->block_count = 0;
+    pool->buffer_end = pool->buffer;
+    
+    smart_exit_critical();
+    return SMART_MEMPOOL_OK;
+}
+
+void smart_mempool_set_name(smart_mempool_t *pool, const char *name)
+{
+    if (pool)
+    {
+        pool->name = name;
+    }
+}
+
+smart_mempool_t *smart_mempool_find(const char *name)
+{
+    if (!name)
+    {
+        return NULL;
+    }
+    
+    smart_mempool_t *pool = mempool_registry;
+    while (pool && !(pool->name && strcmp(pool->name, name) == 0))
+    {
+        pool = pool->next_registered;
+    }
+    return pool;
+}
+
+smart_mempool_t *smart_mempool_next_registered(smart_mempool_t *pool)
+{
+    return pool ? pool->next_registered : mempool_registry;
 }
 
 smart_mempool_status_t smart_mempool_alloc_try(smart_mempool_t *pool, void **out_block)
@@ -77,86 +505,341 @@ smart_mempool_status_t smart_mempool_alloc_try(smart_mempool_t *pool, void **out
         return SMART_MEMPOOL_INVALID;
     }
     
-    smart_mempool_status_t status = SMART_MEMPOOL_OK;
+    /* 先看是否为空，避免空池白白消耗令牌 */
+    if (smart_mempool_is_empty(pool))
+    {
+        return SMART_MEMPOOL_EMPTY;
+    }
     
-    smart_enter_critical();
+    if (!smart_mempool_acquire(pool))
+    {
+        return SMART_MEMPOOL_BUSY;
+    }
     
-    if (pool->ops_left == 0)
+    void *block = smart_mempool_pop(pool);
+    if (!block)
     {
-        status = SMART_MEMPOOL_BUSY;
+        return SMART_MEMPOOL_EMPTY;
     }
-    else if (!pool->free_list)
+    
+#if SMART_MEMPOOL_DEBUG
+    smart_mempool_debug_alloc(pool, block, smart_in_isr() ? NULL : smart_get_current_task());
+#endif
+    *out_block = block;
+    return SMART_MEMPOOL_OK;
+}
+
+/* 块入栈并交给等待者（地址已校验、令牌已取得） */
+static smart_mempool_status_t smart_mempool_give_back(smart_mempool_t *pool, void *block,
+                                                      uint32_t index)
+{
+#if SMART_MEMPOOL_DEBUG
+    if (!smart_mempool_debug_free(pool, block))
     {
-        status = SMART_MEMPOOL_EMPTY;
+        return SMART_MEMPOOL_INVALID;
     }
-    else
+#endif
+    smart_mempool_push(pool, block, index);
+    
+    /* 先入栈再检查等待者：等待者在临界区内确认栈为空后才入队，
+     * 因此两边不会同时错过对方。有等待者时弹出一块直接交给最紧急的任务。
+     */
+    if (pool->wait_list != NULL)
     {
-        void *block = pool->free_list;
-        pool->free_list = *(void **)pool->free_list;
-        pool->free_count--;
-        if (pool->free_count < pool->min_free_count)
+        smart_enter_critical();
+        
+        if (pool->wait_list != NULL)
         {
-            pool->min_free_count = pool->free_count;
+            void *handoff = smart_mempool_pop(pool);
+            if (handoff)
+            {
+                smart_task_t waiter = pool->wait_list;
+#if SMART_MEMPOOL_DEBUG
+                smart_mempool_debug_alloc(pool, handoff, waiter);
+#endif
+                *(void **)waiter->wait_obj = handoff;
+                smart_task_wakeup(waiter, SMART_WAIT_OK);
+                smart_schedule();
+            }
         }
-        pool->ops_left--;
-        *out_block = block;
-        status = SMART_MEMPOOL_OK;
+        
+        smart_exit_critical();
     }
     
-    smart_exit_critical();
-    return status;
+    return SMART_MEMPOOL_OK;
 }
 
 smart_mempool_status_t smart_mempool_free_try(smart_mempool_t *pool, void *block)
 {
-    if (!pool || !block)
+    uint32_t index;
+    
+    if (!pool || !block || !smart_mempool_block_index(pool, block, &index))
     {
         return SMART_MEMPOOL_INVALID;
     }
     
-    smart_mempool_status_t status = SMART_MEMPOOL_OK;
+    if (!smart_mempool_acquire(pool))
+    {
+        return SMART_MEMPOOL_BUSY;
+    }
     
-    smart_enter_critical();
+    return smart_mempool_give_back(pool, block, index);
+}
+
+smart_mempool_status_t smart_mempool_free_unthrottled(smart_mempool_t *pool, void *block)
+{
+    uint32_t index;
+    
+    if (!pool || !block || !smart_mempool_block_index(pool, block, &index))
+    {
+        return SMART_MEMPOOL_INVALID;
+    }
     
-    if (!smart_mempool_address_valid(pool, block))
+    return smart_mempool_give_back(pool, block, index);
+}
+
+smart_mempool_status_t smart_mempool_alloc(smart_mempool_t *pool, void **out_block,
+                                           uint32_t timeout_ms)
+{
+    if (!pool || !out_block)
     {
-        status = SMART_MEMPOOL_INVALID;
+        return SMART_MEMPOOL_INVALID;
     }
-    else if (pool->ops_left == 0)
+    
+    smart_time_t start = smart_get_tick();
+    
+    while (1)
     {
-        status = SMART_MEMPOOL_BUSY;
+        smart_mempool_status_t status = smart_mempool_alloc_try(pool, out_block);
+        smart_task_t current = smart_get_current_task();
+        if (status == SMART_MEMPOOL_OK || status == SMART_MEMPOOL_INVALID ||
+            timeout_ms == 0 || !current)
+        {
+            return status;
+        }
+        
+        smart_time_t elapsed = smart_get_tick() - start;
+        uint32_t remaining = SMART_WAIT_FOREVER;
+        if (timeout_ms != SMART_WAIT_FOREVER)
+        {
+            if (elapsed >= timeout_ms)
+            {
+                return SMART_MEMPOOL_TIMEOUT;
+            }
+            remaining = timeout_ms - elapsed;
+        }
+        
+        if (status == SMART_MEMPOOL_BUSY)
+        {
+            /* 本任务令牌用尽，下一 tick 补充 */
+            smart_delay(1);
+            continue;
+        }
+        
+        smart_enter_critical();
+        
+        /* 关中断前可能刚有块被释放，重新检查 */
+        if (!smart_mempool_is_empty(pool))
+        {
+            smart_exit_critical();
+            continue;
+        }
+        
+        /* 阻塞等待，释放者把块直接写入 out_block */
+        current->wait_obj = out_block;
+        uint8_t result = smart_task_block(&pool->wait_list, remaining);
+        current->wait_obj = NULL;
+        
+        smart_exit_critical();
+        
+        return (result == SMART_WAIT_OK) ? SMART_MEMPOOL_OK : SMART_MEMPOOL_TIMEOUT;
     }
-    else
+}
+
+#if SMART_MEMPOOL_CACHE
+
+/* 查找当前任务在 pool 上的缓存，中断上下文不使用缓存 */
+static smart_mempool_cache_t *smart_mempool_cache_find(const smart_mempool_t *pool)
+{
+#if SMART_MEMPOOL_DEBUG
+    /* 调试模式下每次分配/释放都经过池的检查 */
+    (void)pool;
+    return NULL;
+#else
+    smart_task_t current = smart_get_current_task();
+    if (!current || smart_in_isr())
     {
-        *(void **)block = pool->free_list;
-        pool->free_list = block;
-        pool->free_count++;
-        pool->ops_left--;
-        status = SMART_MEMPOOL_OK;
+        return NULL;
     }
     
-    smart_exit_critical();
-    return status;
+    smart_mempool_cache_t *cache = (smart_mempool_cache_t *)current->alloc_cache;
+    while (cache && cache->pool != pool)
+    {
+        cache = cache->next;
+    }
+    return cache;
+#endif
+}
+
+/* 归还块直到只剩 keep 个，遇到限流时停止 */
+static smart_mempool_status_t smart_mempool_cache_drain(smart_mempool_cache_t *cache,
+                                                        uint32_t keep)
+{
+    while (cache->count > keep)
+    {
+        smart_mempool_status_t status =
+            smart_mempool_free_try(cache->pool, cache->blocks[cache->count - 1u]);
+        if (status != SMART_MEMPOOL_OK)
+        {
+            return status;
+        }
+        cache->count--;
+    }
+    return SMART_MEMPOOL_OK;
+}
+
+/* 全部归还（等待限流恢复） */
+static void smart_mempool_cache_flush(smart_mempool_cache_t *cache)
+{
+    while (smart_mempool_cache_drain(cache, 0) == SMART_MEMPOOL_BUSY)
+    {
+        smart_delay(1);
+    }
+}
+
+int smart_mempool_cache_attach(smart_mempool_cache_t *cache, smart_mempool_t *pool)
+{
+    smart_task_t current = smart_get_current_task();
+    if (!cache || !pool || !current || smart_mempool_cache_find(pool))
+    {
+        return -1;
+    }
+    
+    cache->pool = pool;
+    cache->count = 0;
+    cache->next = (smart_mempool_cache_t *)current->alloc_cache;
+    current->alloc_cache = cache;
+    return 0;
+}
+
+void smart_mempool_cache_detach(smart_mempool_cache_t *cache)
+{
+    smart_task_t current = smart_get_current_task();
+    if (!cache || !current)
+    {
+        return;
+    }
+    
+    smart_mempool_cache_flush(cache);
+    
+    smart_mempool_cache_t **link = (smart_mempool_cache_t **)&current->alloc_cache;
+    while (*link && *link != cache)
+    {
+        link = &(*link)->next;
+    }
+    if (*link)
+    {
+        *link = cache->next;
+    }
+    cache->next = NULL;
+}
+
+smart_mempool_status_t smart_mempool_cache_alloc(smart_mempool_t *pool, void **out_block)
+{
+    if (!pool || !out_block)
+    {
+        return SMART_MEMPOOL_INVALID;
+    }
+    
+    smart_mempool_cache_t *cache = smart_mempool_cache_find(pool);
+    if (!cache)
+    {
+        return smart_mempool_alloc_try(pool, out_block);
+    }
+    
+    if (cache->count == 0)
+    {
+        /* 缓存空：从池中批量补充 */
+        smart_mempool_status_t status = SMART_MEMPOOL_OK;
+        while (cache->count < SMART_MEMPOOL_CACHE_BATCH)
+        {
+            status = smart_mempool_alloc_try(pool, &cache->blocks[cache->count]);
+            if (status != SMART_MEMPOOL_OK)
+            {
+                break;
+            }
+            cache->count++;
+        }
+        
+        if (cache->count == 0)
+        {
+            return status;
+        }
+    }
+    
+    *out_block = cache->blocks[--cache->count];
+    return SMART_MEMPOOL_OK;
+}
+
+smart_mempool_status_t smart_mempool_cache_free(smart_mempool_t *pool, void *block)
+{
+    uint32_t index;
+    
+    if (!pool || !block || !smart_mempool_block_index(pool, block, &index))
+    {
+        return SMART_MEMPOOL_INVALID;
+    }
+    
+    /* 有任务在等块时不要囤在缓存里 */
+    smart_mempool_cache_t *cache = smart_mempool_cache_find(pool);
+    if (!cache || pool->wait_list != NULL)
+    {
+        return smart_mempool_free_try(pool, block);
+    }
+    
+    if (cache->count == SMART_MEMPOOL_CACHE_SIZE)
+    {
+        /* 缓存满：批量归还一半，限流时直接交给池处理 */
+        if (smart_mempool_cache_drain(cache, SMART_MEMPOOL_CACHE_SIZE - SMART_MEMPOOL_CACHE_BATCH)
+            != SMART_MEMPOOL_OK)
+        {
+            return smart_mempool_free_try(pool, block);
+        }
+    }
+    
+    cache->blocks[cache->count++] = block;
+    return SMART_MEMPOOL_OK;
 }
 
-void smart_mempool_tick(void)
+void smart_mempool_cache_flush_task(smart_task_t task)
 {
-    for (uint32_t i = 0; i < pool_registry_count; ++i)
+    if (!task)
     {
-        smart_mempool_t *pool = pool_registry[i];
-        if (!pool) continue;
-        pool->ops_left = pool->ops_per_tick;
+        return;
+    }
+    
+    smart_mempool_cache_t *cache = (smart_mempool_cache_t *)task->alloc_cache;
+    task->alloc_cache = NULL;
+    
+    while (cache)
+    {
+        smart_mempool_cache_t *next = cache->next;
+        smart_mempool_cache_flush(cache);
+        cache->next = NULL;
+        cache = next;
     }
 }
 
+#endif
+
 uint16_t smart_mempool_get_free(const smart_mempool_t *pool)
 {
-    return pool ? pool->free_count : 0u;
+    return pool ? (uint16_t)pool->free_count : 0u;
 }
 
 uint16_t smart_mempool_get_min_free(const smart_mempool_t *pool)
 {
-    return pool ? pool->min_free_count : 0u;
+    return pool ? (uint16_t)pool->min_free_count : 0u;
 }
 
 
@@ -171,8 +854,8 @@ void smart_mempool_get_stats(const smart_mempool_t *pool, smart_mempool_stats_t
     
     stats->block_size = pool->block_size;
     stats->block_count = pool->block_count;
-    stats->free_count = pool->free_count;
-    stats->min_free_count = pool->min_free_count;
+    stats->free_count = (uint16_t)pool->free_count;
+    stats->min_free_count = (uint16_t)pool->min_free_count;
     
     smart_exit_critical();
 }
@@ -3,44 +3,178 @@
 
 #include <stdint.h>
 #include <stddef.h>
+#include "smart_core.h"
 
 typedef enum
 {
     SMART_MEMPOOL_OK = 0,
     SMART_MEMPOOL_EMPTY,
     SMART_MEMPOOL_BUSY,
-    SMART_MEMPOOL_INVALID
+    SMART_MEMPOOL_INVALID,
+    SMART_MEMPOOL_TIMEOUT
 } smart_mempool_status_t;
 
+/* 令牌桶限流：每个任务在每个池上有独立的令牌桶，每 tick 补充 ops_per_tick 个令牌，
+ * 最多积累 SMART_MEMPOOL_BURST_TICKS 个 tick 的量；补充在访问时按时间戳差值计算，
+ * 不占用 SysTick。中断上下文和桶表已满时使用池内共享的桶。
+ */
+#ifndef SMART_MEMPOOL_TASK_BUCKETS
+#define SMART_MEMPOOL_TASK_BUCKETS 2
+#endif
+
+#ifndef SMART_MEMPOOL_BURST_TICKS
+#define SMART_MEMPOOL_BURST_TICKS 4u
+#endif
+
+typedef struct
+{
+    smart_task_t owner;     /* 所属任务，NULL 表示空闲（共享桶恒为 NULL） */
+    smart_time_t last;      /* 上次补充令牌的 tick */
+    uint16_t tokens;        /* 剩余令牌 */
+} smart_mempool_bucket_t;
+
+/* 调试模式：每块在载荷之后附加红区和尾部记录
+ *   [载荷 block_size，填充到 4 字节][红区 SMART_MEMPOOL_REDZONE][smart_mempool_trailer_t]
+ * 释放时检查红区（越界写）与状态（重复释放），空闲块载荷填充毒化字节，
+ * 分配时检查毒化字节（释放后写入）。关闭时不增加任何字段和代码。
+ */
+#ifndef SMART_MEMPOOL_DEBUG
+#define SMART_MEMPOOL_DEBUG 0
+#endif
+
+#if SMART_MEMPOOL_DEBUG
+#define SMART_MEMPOOL_REDZONE       8u
+#define SMART_MEMPOOL_REDZONE_BYTE  0xFDu
+#define SMART_MEMPOOL_POISON_BYTE   0xDDu
+
+typedef struct
+{
+    smart_task_t owner;         /* 分配者（中断中分配为 NULL） */
+    smart_time_t tick;          /* 分配时刻 */
+    volatile uint32_t state;    /* 块状态魔数 */
+} smart_mempool_trailer_t;
+
+#define SMART_MEMPOOL_DEBUG_OVERHEAD  (SMART_MEMPOOL_REDZONE + sizeof(smart_mempool_trailer_t))
+#else
+#define SMART_MEMPOOL_DEBUG_OVERHEAD  0u
+#endif
+
+/* 每块实际占用的字节数，调用者按 SMART_MEMPOOL_BUFFER_SIZE 分配缓冲区 */
+#define SMART_MEMPOOL_STRIDE(block_size)  \
+    ((((uint32_t)(block_size) + 3u) & ~3u) + SMART_MEMPOOL_DEBUG_OVERHEAD)
+#define SMART_MEMPOOL_BUFFER_SIZE(block_size, block_count)  \
+    (SMART_MEMPOOL_STRIDE(block_size) * (block_count))
+
 typedef struct smart_mempool
 {
     uint8_t *buffer;
     uint8_t *buffer_end;
     uint32_t block_size;
     uint32_t block_stride;
+    uint32_t stride_recip;   /* ceil(2^32 / block_stride)，用乘法把偏移换算为块索引 */
     uint16_t block_count;
-    uint16_t free_count;
-    uint16_t ops_per_tick;
-    uint16_t ops_left;
-    void *free_list;
-    uint16_t min_free_count; /* 运行过程中记录的最小剩余块数 */
+    uint16_t ops_per_tick;   /* 每任务每 tick 的操作配额，0 表示不限流 */
+    volatile uint32_t free_head;       /* 空闲栈顶：高 16 位版本号，低 16 位块索引 */
+    volatile uint32_t free_count;
+    volatile uint32_t min_free_count;  /* 运行过程中记录的最小剩余块数 */
+    smart_task_t wait_list;  /* 等待空闲块的任务（按deadline排序） */
+    smart_mempool_bucket_t buckets[SMART_MEMPOOL_TASK_BUCKETS + 1];  /* 最后一个为共享桶 */
+    
+    /* 注册表（meminfo/free/memdbg 遍历） */
+    const char *name;
+    struct smart_mempool *next_registered;
 } smart_mempool_t;
 
-void smart_mempool_init(smart_mempool_t *pool,
-                        void *buffer,
-                        uint32_t block_size,
-                        uint32_t block_count,
-                        uint16_t ops_per_tick);
+/* 初始化并加入注册表；池已注册时返回 BUSY，需先 smart_mempool_deinit 再重新初始化 */
+smart_mempool_status_t smart_mempool_init(smart_mempool_t *pool,
+                                          void *buffer,
+                                          uint32_t block_size,
+                                          uint32_t block_count,
+                                          uint16_t ops_per_tick);
+
+/* 从注册表移除；仍有块未归还（含每任务缓存中的块）或有任务等待时返回 BUSY */
+smart_mempool_status_t smart_mempool_deinit(smart_mempool_t *pool);
+
+/* 设置名字（用于 Shell 显示与查找） */
+void smart_mempool_set_name(smart_mempool_t *pool, const char *name);
+
+/* 按名字查找已注册的池 */
+smart_mempool_t *smart_mempool_find(const char *name);
+
+/* 遍历注册表：传 NULL 返回第一个 */
+smart_mempool_t *smart_mempool_next_registered(smart_mempool_t *pool);
+
+/* 非阻塞分配/释放：空闲链表为带版本号的无锁栈（LDREX/STREX），不关中断；
+ * 仅在限流（ops_per_tick != 0）或有任务阻塞等待时短暂进入临界区。
+ * 高于 SMART_KERNEL_IRQ_CEILING 的中断只能使用不限流且没有阻塞等待者的池。
+ * 块数不能超过 SMART_MEMPOOL_MAX_BLOCKS。
+ */
+#define SMART_MEMPOOL_MAX_BLOCKS  0xFFFEu
 
 smart_mempool_status_t smart_mempool_alloc_try(smart_mempool_t *pool, void **out_block);
 smart_mempool_status_t smart_mempool_free_try(smart_mempool_t *pool, void *block);
 
-void smart_mempool_tick(void);
+/* 释放但不消耗令牌，永不返回 BUSY：用于不能等待的归还路径（如引用计数归零，可能在中断中） */
+smart_mempool_status_t smart_mempool_free_unthrottled(smart_mempool_t *pool, void *block);
+
+/* 阻塞分配：内存池为空时最多等待 timeout_ms（SMART_WAIT_FOREVER 永久等待）
+ * 释放的块直接交给截止时间最早的等待者；本任务令牌用尽时等到下一 tick
+ * 中断中只能使用 timeout_ms=0（等同于 smart_mempool_alloc_try）
+ */
+smart_mempool_status_t smart_mempool_alloc(smart_mempool_t *pool, void **out_block,
+                                           uint32_t timeout_ms);
 
 uint16_t smart_mempool_get_free(const smart_mempool_t *pool);
 uint16_t smart_mempool_get_min_free(const smart_mempool_t *pool);
 
-/* 获取全局内存池统计信息（用于Shell命令） */
+/* ========== 每任务块缓存（magazine） ==========
+ * 任务把缓存挂到自己的 TCB 上后，smart_mempool_cache_alloc/free 优先在
+ * 本任务的缓存中取放块，只访问任务私有数据；缓存空时从池中批量补充一半，
+ * 满时批量归还一半。池中有任务阻塞等待时释放直接还给池。
+ * 缓存中的块在池统计中计为已分配；任务退出时由 smart_task_exit 全部归还。
+ * 调试模式下不使用缓存，每次分配/释放都经过池的检查。
+ */
+#ifndef SMART_MEMPOOL_CACHE
+#define SMART_MEMPOOL_CACHE 1
+#endif
+
+#if SMART_MEMPOOL_CACHE
+
+#ifndef SMART_MEMPOOL_CACHE_SIZE
+#define SMART_MEMPOOL_CACHE_SIZE 8u
+#endif
+
+#define SMART_MEMPOOL_CACHE_BATCH  (SMART_MEMPOOL_CACHE_SIZE / 2u)
+
+typedef struct smart_mempool_cache
+{
+    smart_mempool_t *pool;
+    struct smart_mempool_cache *next;   /* 同一任务的下一个缓存 */
+    uint32_t count;
+    void *blocks[SMART_MEMPOOL_CACHE_SIZE];
+} smart_mempool_cache_t;
+
+/* 把缓存挂到当前任务上，之后该任务对 pool 的 cache_alloc/free 经过此缓存 */
+int smart_mempool_cache_attach(smart_mempool_cache_t *cache, smart_mempool_t *pool);
+
+/* 归还缓存中的全部块并从当前任务上摘下 */
+void smart_mempool_cache_detach(smart_mempool_cache_t *cache);
+
+/* 经由当前任务缓存分配/释放；中断中或任务没有该池的缓存时等同于 _try 版本 */
+smart_mempool_status_t smart_mempool_cache_alloc(smart_mempool_t *pool, void **out_block);
+smart_mempool_status_t smart_mempool_cache_free(smart_mempool_t *pool, void *block);
+
+/* 归还任务全部缓存（任务退出时调用） */
+void smart_mempool_cache_flush_task(smart_task_t task);
+
+#endif
+
+#if SMART_MEMPOOL_DEBUG
+/* 按任务列出所有池中未释放的块（Shell 命令 memdbg） */
+void smart_mempool_debug_dump(void);
+#endif
+
+/* 内存池统计信息（用于Shell命令） */
 typedef struct {
     uint32_t block_size;
     uint16_t block_count;
@@ -50,8 +184,5 @@ typedef struct {
 
 void smart_mempool_get_stats(const smart_mempool_t *pool, smart_mempool_stats_t *stats);
 
-/* 获取全局内存池（由应用层提供） */
-smart_mempool_t *smart_get_mempool(void);
-
 #endif
 
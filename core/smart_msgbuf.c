@@ -0,0 +1,340 @@
+#include "smart_msgbuf.h"
+#include <string.h>
+
+/* 记录占用字节数：头部 + 数据向上取整到 4 字节 */
+#define MSGBUF_RECORD_SIZE(len)  (SMART_MSGBUF_HDR_SIZE + (((len) + 3u) & ~3u))
+
+static uint32_t *smart_msgbuf_header(smart_msgbuf_t *mb, uint32_t offset)
+{
+    return (uint32_t *)(mb->buffer + offset);
+}
+
+/* 读位置遇到回绕标记时跳回开头，释放尾部作废的空间 */
+static void smart_msgbuf_skip_wrap(smart_msgbuf_t *mb)
+{
+    if (*smart_msgbuf_header(mb, mb->head) == SMART_MSGBUF_WRAP_MARK)
+    {
+        mb->used -= mb->size - mb->head;
+        mb->head = 0;
+    }
+}
+
+/* 计算剩余等待时间（在临界区内调用） */
+static uint32_t smart_msgbuf_remaining(uint32_t timeout_ms, smart_time_t start)
+{
+    if (timeout_ms == SMART_WAIT_FOREVER)
+    {
+        return SMART_WAIT_FOREVER;
+    }
+    
+    smart_time_t elapsed = smart_get_tick() - start;
+    return (elapsed >= timeout_ms) ? 0 : timeout_ms - elapsed;
+}
+
+/* 唤醒全部写者，按截止时间依次重新检查（在临界区内调用，调用者负责调度） */
+static int smart_msgbuf_wake_writers(smart_msgbuf_t *mb)
+{
+    int woke = 0;
+    while (mb->send_wait_list != NULL)
+    {
+        smart_task_wakeup(mb->send_wait_list, SMART_WAIT_OK);
+        woke = 1;
+    }
+    return woke;
+}
+
+/* 查找一段能放下 rec 字节的连续空间，找到返回 1 */
+static int smart_msgbuf_find_space(smart_msgbuf_t *mb, uint32_t rec,
+                                   uint32_t *offset, uint32_t *waste)
+{
+    /* 空缓冲区：复位到开头，获得最大的连续空间 */
+    if (mb->used == 0)
+    {
+        mb->head = 0;
+        mb->tail = 0;
+    }
+    
+    *waste = 0;
+    
+    if (mb->used == 0 || mb->tail > mb->head)
+    {
+        /* 数据位于 [head, tail)，空闲区为尾部和开头两段 */
+        uint32_t end_space = mb->size - mb->tail;
+        if (rec <= end_space)
+        {
+            *offset = mb->tail;
+            return 1;
+        }
+        
+        /* 尾部放不下：回绕到开头，尾部剩余空间作废 */
+        if (rec <= mb->head)
+        {
+            *offset = 0;
+            *waste = end_space;
+            return 1;
+        }
+        return 0;
+    }
+    
+    /* 数据已回绕，空闲区为 [tail, head) */
+    if (rec <= mb->head - mb->tail)
+    {
+        *offset = mb->tail;
+        return 1;
+    }
+    return 0;
+}
+
+void smart_msgbuf_init(smart_msgbuf_t *mb, void *buffer, uint32_t size)
+{
+    if (!mb || !buffer)
+    {
+        return;
+    }
+    
+    smart_enter_critical();
+    
+    mb->buffer = (uint8_t *)buffer;
+    mb->size = size & ~3u;
+    mb->head = 0;
+    mb->tail = 0;
+    mb->used = 0;
+    mb->count = 0;
+    mb->dropped = 0;
+    mb->reserve_len = 0;
+    mb->reserve_offset = 0;
+    mb->reserve_waste = 0;
+    mb->send_wait_list = NULL;
+    mb->recv_wait_list = NULL;
+    
+    smart_exit_critical();
+}
+
+smart_msgq_status_t smart_msgbuf_reserve(smart_msgbuf_t *mb, uint32_t len, void **data,
+                                         uint32_t timeout_ms)
+{
+    if (!mb || !data || len == 0 || len > mb->size || MSGBUF_RECORD_SIZE(len) > mb->size)
+    {
+        return SMART_MSGQ_INVALID;
+    }
+    
+    uint32_t rec = MSGBUF_RECORD_SIZE(len);
+    smart_time_t start = smart_get_tick();
+    
+    smart_enter_critical();
+    
+    /* 同一时刻只允许一个预留：已有预留或空间不足时都在 send_wait_list 上等待，
+     * 提交和消费都会唤醒写者重新检查
+     */
+    uint32_t offset;
+    uint32_t waste;
+    while (mb->reserve_len != 0 || !smart_msgbuf_find_space(mb, rec, &offset, &waste))
+    {
+        smart_task_t current = smart_get_current_task();
+        uint32_t remaining = smart_msgbuf_remaining(timeout_ms, start);
+        if (remaining == 0 || !current)
+        {
+            mb->dropped++;
+            smart_exit_critical();
+            return (timeout_ms == 0) ? SMART_MSGQ_FULL : SMART_MSGQ_TIMEOUT;
+        }
+        
+        if (smart_task_block(&mb->send_wait_list, remaining) != SMART_WAIT_OK)
+        {
+            mb->dropped++;
+            smart_exit_critical();
+            return SMART_MSGQ_TIMEOUT;
+        }
+    }
+    
+    mb->reserve_len = len;
+    mb->reserve_offset = offset;
+    mb->reserve_waste = waste;
+    
+    smart_exit_critical();
+    
+    /* 预留区尚未提交，读者不会访问，可在临界区外原地填充 */
+    *data = mb->buffer + offset + SMART_MSGBUF_HDR_SIZE;
+    return SMART_MSGQ_OK;
+}
+
+smart_msgq_status_t smart_msgbuf_commit(smart_msgbuf_t *mb, uint32_t len)
+{
+    if (!mb)
+    {
+        return SMART_MSGQ_INVALID;
+    }
+    
+    smart_enter_critical();
+    
+    if (mb->reserve_len == 0 || len == 0 || len > mb->reserve_len)
+    {
+        smart_exit_critical();
+        return SMART_MSGQ_INVALID;
+    }
+    
+    /* 回绕时在旧写位置留下标记，读者遇到后跳回开头 */
+    if (mb->reserve_waste >= SMART_MSGBUF_HDR_SIZE)
+    {
+        *smart_msgbuf_header(mb, mb->tail) = SMART_MSGBUF_WRAP_MARK;
+    }
+    
+    uint32_t rec = MSGBUF_RECORD_SIZE(len);
+    *smart_msgbuf_header(mb, mb->reserve_offset) = len;
+    
+    mb->tail = mb->reserve_offset + rec;
+    if (mb->tail >= mb->size)
+    {
+        mb->tail = 0;
+    }
+    mb->used += mb->reserve_waste + rec;
+    mb->count++;
+    mb->reserve_len = 0;
+    
+    /* 唤醒最紧急的读者，以及等待预留释放的写者 */
+    int woke = smart_msgbuf_wake_writers(mb);
+    if (mb->recv_wait_list != NULL)
+    {
+        smart_task_wakeup(mb->recv_wait_list, SMART_WAIT_OK);
+        woke = 1;
+    }
+    if (woke)
+    {
+        smart_schedule();
+    }
+    
+    smart_exit_critical();
+    
+    return SMART_MSGQ_OK;
+}
+
+smart_msgq_status_t smart_msgbuf_peek(smart_msgbuf_t *mb, void **data, uint32_t *len,
+                                      uint32_t timeout_ms)
+{
+    if (!mb || !data || !len)
+    {
+        return SMART_MSGQ_INVALID;
+    }
+    
+    smart_time_t start = smart_get_tick();
+    
+    smart_enter_critical();
+    
+    while (mb->count == 0)
+    {
+        smart_task_t current = smart_get_current_task();
+        uint32_t remaining = smart_msgbuf_remaining(timeout_ms, start);
+        if (remaining == 0 || !current)
+        {
+            smart_exit_critical();
+            return (timeout_ms == 0) ? SMART_MSGQ_EMPTY : SMART_MSGQ_TIMEOUT;
+        }
+        
+        if (smart_task_block(&mb->recv_wait_list, remaining) != SMART_WAIT_OK)
+        {
+            smart_exit_critical();
+            return SMART_MSGQ_TIMEOUT;
+        }
+    }
+    
+    smart_msgbuf_skip_wrap(mb);
+    
+    *len = *smart_msgbuf_header(mb, mb->head);
+    *data = mb->buffer + mb->head + SMART_MSGBUF_HDR_SIZE;
+    
+    smart_exit_critical();
+    
+    return SMART_MSGQ_OK;
+}
+
+smart_msgq_status_t smart_msgbuf_consume(smart_msgbuf_t *mb)
+{
+    if (!mb)
+    {
+        return SMART_MSGQ_INVALID;
+    }
+    
+    smart_enter_critical();
+    
+    if (mb->count == 0)
+    {
+        smart_exit_critical();
+        return SMART_MSGQ_EMPTY;
+    }
+    
+    smart_msgbuf_skip_wrap(mb);
+    uint32_t rec = MSGBUF_RECORD_SIZE(*smart_msgbuf_header(mb, mb->head));
+    mb->head += rec;
+    if (mb->head >= mb->size)
+    {
+        mb->head = 0;
+    }
+    mb->used -= rec;
+    mb->count--;
+    
+    /* 记录长度不一，无法判断谁能放下：唤醒全部写者按截止时间依次重试 */
+    if (smart_msgbuf_wake_writers(mb))
+    {
+        smart_schedule();
+    }
+    
+    smart_exit_critical();
+    
+    return SMART_MSGQ_OK;
+}
+
+smart_msgq_status_t smart_msgbuf_send(smart_msgbuf_t *mb, const void *data, uint32_t len,
+                                      uint32_t timeout_ms)
+{
+    if (!data)
+    {
+        return SMART_MSGQ_INVALID;
+    }
+    
+    void *slot;
+    smart_msgq_status_t status = smart_msgbuf_reserve(mb, len, &slot, timeout_ms);
+    if (status != SMART_MSGQ_OK)
+    {
+        return status;
+    }
+    
+    memcpy(slot, data, len);
+    return smart_msgbuf_commit(mb, len);
+}
+
+smart_msgq_status_t smart_msgbuf_receive(smart_msgbuf_t *mb, void *data, uint32_t max_len,
+                                         uint32_t *len, uint32_t timeout_ms)
+{
+    if (!data || !len)
+    {
+        return SMART_MSGQ_INVALID;
+    }
+    
+    void *record;
+    uint32_t record_len;
+    smart_msgq_status_t status = smart_msgbuf_peek(mb, &record, &record_len, timeout_ms);
+    if (status != SMART_MSGQ_OK)
+    {
+        return status;
+    }
+    
+    if (record_len > max_len)
+    {
+        *len = record_len;
+        return SMART_MSGQ_INVALID;
+    }
+    
+    memcpy(data, record, record_len);
+    *len = record_len;
+    return smart_msgbuf_consume(mb);
+}
+
+uint32_t smart_msgbuf_count(const smart_msgbuf_t *mb)
+{
+    return mb ? mb->count : 0;
+}
+
+uint32_t smart_msgbuf_free_bytes(const smart_msgbuf_t *mb)
+{
+    return mb ? mb->size - mb->used : 0;
+}
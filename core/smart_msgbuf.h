@@ -0,0 +1,67 @@
+#ifndef __SMART_MSGBUF_H__
+#define __SMART_MSGBUF_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include "smart_core.h"
+#include "smart_msgqueue.h"
+
+/* 变长消息缓冲区：在一块连续环形内存中存放带长度前缀的记录
+ * 记录格式：[uint32_t 长度][数据，填充到 4 字节]
+ * 尾部放不下时写入回绕标记，记录从缓冲区开头继续，保证每条记录连续。
+ * 写入支持 reserve/commit 原地填充，读取支持 peek/consume 原地读取；
+ * 两者各自只允许一个任务同时持有（单写者预留、单读者窥视）。
+ */
+
+#define SMART_MSGBUF_HDR_SIZE   4u
+#define SMART_MSGBUF_WRAP_MARK  0xFFFFFFFFu
+
+typedef struct
+{
+    uint8_t *buffer;        /* 缓冲区（4字节对齐） */
+    uint32_t size;          /* 缓冲区字节数（4的倍数） */
+    uint32_t head;          /* 读偏移 */
+    uint32_t tail;          /* 写偏移 */
+    uint32_t used;          /* 已占用字节（含记录头、填充与回绕浪费） */
+    uint32_t count;         /* 记录数 */
+    uint32_t dropped;       /* 空间不足被丢弃的写入次数 */
+
+    /* 写者预留状态 */
+    uint32_t reserve_len;     /* 预留的数据长度，0 表示无预留 */
+    uint32_t reserve_offset;  /* 记录起始偏移 */
+    uint32_t reserve_waste;   /* 回绕造成的尾部浪费字节 */
+
+    smart_task_t send_wait_list;  /* 空间不足时阻塞的写者 */
+    smart_task_t recv_wait_list;  /* 缓冲区为空时阻塞的读者 */
+} smart_msgbuf_t;
+
+/* 初始化（buffer 需 4 字节对齐，size 向下取整到 4 的倍数） */
+void smart_msgbuf_init(smart_msgbuf_t *mb, void *buffer, uint32_t size);
+
+/* 预留一段连续空间用于原地写入；空间不足或其他任务的预留尚未提交时最多阻塞 timeout_ms */
+smart_msgq_status_t smart_msgbuf_reserve(smart_msgbuf_t *mb, uint32_t len, void **data,
+                                         uint32_t timeout_ms);
+
+/* 提交预留空间中的前 len 字节为一条记录（len 不超过预留长度） */
+smart_msgq_status_t smart_msgbuf_commit(smart_msgbuf_t *mb, uint32_t len);
+
+/* 窥视最早的记录（不移除），为空时最多阻塞 timeout_ms */
+smart_msgq_status_t smart_msgbuf_peek(smart_msgbuf_t *mb, void **data, uint32_t *len,
+                                      uint32_t timeout_ms);
+
+/* 移除 peek 到的记录，释放空间 */
+smart_msgq_status_t smart_msgbuf_consume(smart_msgbuf_t *mb);
+
+/* 拷贝写入一条记录 */
+smart_msgq_status_t smart_msgbuf_send(smart_msgbuf_t *mb, const void *data, uint32_t len,
+                                      uint32_t timeout_ms);
+
+/* 拷贝读出一条记录；记录长于 max_len 时返回 SMART_MSGQ_INVALID 且不移除 */
+smart_msgq_status_t smart_msgbuf_receive(smart_msgbuf_t *mb, void *data, uint32_t max_len,
+                                         uint32_t *len, uint32_t timeout_ms);
+
+/* 查询状态 */
+uint32_t smart_msgbuf_count(const smart_msgbuf_t *mb);
+uint32_t smart_msgbuf_free_bytes(const smart_msgbuf_t *mb);
+
+#endif
@@ -1,7 +1,142 @@
 #include "smart_msgqueue.h"
 #include "smart_core.h"
+#include "smart_atomic.h"
 #include <string.h>
 
+/* 注册表 */
+static smart_msgqueue_t *msgqueue_registry = NULL;
+static smart_prio_msgqueue_t *prio_msgqueue_registry = NULL;
+
+#if SMART_MSGQ_STATS
+/* 入队后记录水位线与深度分布（临界区内调用） */
+static void smart_msgqueue_note_depth(smart_msgqueue_t *queue)
+{
+    smart_msgq_stats_t *stats = &queue->stats;
+    uint32_t count = queue->count;
+    
+    if (count > stats->high_water)
+    {
+        stats->high_water = count;
+    }
+    
+    stats->depth_hist[(count - 1u) * SMART_MSGQ_HIST_BINS / queue->capacity]++;
+}
+
+/* 出队时记录入队到出队的延迟 */
+static void smart_msgqueue_note_latency(smart_msgqueue_t *queue, const smart_msg_t *msg)
+{
+    smart_msgq_stats_t *stats = &queue->stats;
+    uint32_t latency = smart_get_cycles() - msg->timestamp;
+    
+    if (latency > stats->latency_max)
+    {
+        stats->latency_max = latency;
+    }
+    
+    /* 与任务执行时间预测相同的 EMA：avg += (sample - avg) / 8 */
+    if (stats->latency_samples == 0)
+    {
+        stats->latency_avg = latency;
+    }
+    else
+    {
+        stats->latency_avg = (uint32_t)((int32_t)stats->latency_avg +
+                                        (((int32_t)latency - (int32_t)stats->latency_avg) >> 3));
+    }
+    stats->latency_samples++;
+}
+
+/* 给 index 起的 n 条缓冲区消息打时间戳 */
+static void smart_msgqueue_stamp(smart_msgqueue_t *queue, uint32_t index, uint32_t n, uint32_t stamp)
+{
+    while (n--)
+    {
+        queue->buffer[index].timestamp = stamp;
+        if (++index >= queue->capacity)
+        {
+            index = 0;
+        }
+    }
+}
+#endif
+
+/* 把 n 条消息写入队尾，环绕时分两段拷贝（调用者保证空间足够） */
+static void smart_msgqueue_copy_in(smart_msgqueue_t *queue, const smart_msg_t *msgs, uint32_t n)
+{
+    uint32_t first = queue->capacity - queue->tail;
+    if (first > n)
+    {
+        first = n;
+    }
+    
+    memcpy(&queue->buffer[queue->tail], msgs, first * sizeof(smart_msg_t));
+    memcpy(queue->buffer, msgs + first, (n - first) * sizeof(smart_msg_t));
+    
+    queue->tail += n;
+    if (queue->tail >= queue->capacity)
+    {
+        queue->tail -= queue->capacity;
+    }
+    queue->count += n;
+}
+
+/* 从队头取出 n 条消息，环绕时分两段拷贝（调用者保证消息足够） */
+static void smart_msgqueue_copy_out(smart_msgqueue_t *queue, smart_msg_t *msgs, uint32_t n)
+{
+    uint32_t first = queue->capacity - queue->head;
+    if (first > n)
+    {
+        first = n;
+    }
+    
+    memcpy(msgs, &queue->buffer[queue->head], first * sizeof(smart_msg_t));
+    memcpy(msgs + first, queue->buffer, (n - first) * sizeof(smart_msg_t));
+    
+    queue->head += n;
+    if (queue->head >= queue->capacity)
+    {
+        queue->head -= queue->capacity;
+    }
+    queue->count -= n;
+}
+
+/* 把队头消息交给最紧急的等待接收者（临界区内调用），返回是否唤醒了任务。
+ * 每次只唤醒一个，被唤醒者返回时再接力交给下一个，保证队列非空时不会有接收者一直阻塞
+ */
+static int smart_msgqueue_feed_receiver(smart_msgqueue_t *queue)
+{
+    if (queue->count == 0 || queue->recv_wait_list == NULL)
+    {
+        return 0;
+    }
+    
+    smart_task_t receiver = queue->recv_wait_list;
+    smart_msgqueue_copy_out(queue, (smart_msg_t *)receiver->wait_obj, 1);
+    smart_task_wakeup(receiver, SMART_WAIT_OK);
+    return 1;
+}
+
+/* 有空位时把最紧急等待发送者的消息补入队尾（临界区内调用），返回是否唤醒了任务 */
+static int smart_msgqueue_admit_sender(smart_msgqueue_t *queue)
+{
+    if (queue->count >= queue->capacity || queue->send_wait_list == NULL)
+    {
+        return 0;
+    }
+    
+    smart_task_t sender = queue->send_wait_list;
+#if SMART_MSGQ_STATS
+    uint32_t slot = queue->tail;
+#endif
+    smart_msgqueue_copy_in(queue, (const smart_msg_t *)sender->wait_obj, 1);
+#if SMART_MSGQ_STATS
+    queue->buffer[slot].timestamp = sender->wait_value;
+    smart_msgqueue_note_depth(queue);
+#endif
+    smart_task_wakeup(sender, SMART_WAIT_OK);
+    return 1;
+}
+
 /* 初始化消息队列 */
 void smart_msgqueue_init(smart_msgqueue_t *queue, smart_msg_t *buffer, uint32_t capacity)
 {
@@ -18,6 +153,11 @@ void smart_msgqueue_init(smart_msgqueue_t *queue, smart_msg_t *buffer, uint32_t
     queue->head = 0;
     queue->tail = 0;
     queue->dropped = 0;
+    queue->send_wait_list = NULL;
+    queue->recv_wait_list = NULL;
+#if SMART_MSGQ_STATS
+    memset(&queue->stats, 0, sizeof(queue->stats));
+#endif
     
     /* 清空缓冲区 */
     memset(buffer, 0, sizeof(smart_msg_t) * capacity);
@@ -27,6 +167,19 @@ void smart_msgqueue_init(smart_msgqueue_t *queue, smart_msg_t *buffer, uint32_t
 
 /* 发送消息（非阻塞） */
 smart_msgq_status_t smart_msgqueue_send(smart_msgqueue_t *queue, const smart_msg_t *msg)
+{
+    return smart_msgqueue_send_timeout(queue, msg, 0);
+}
+
+/* 接收消息（非阻塞） */
+smart_msgq_status_t smart_msgqueue_receive(smart_msgqueue_t *queue, smart_msg_t *msg)
+{
+    return smart_msgqueue_receive_timeout(queue, msg, 0);
+}
+
+/* 发送消息（带超时） */
+smart_msgq_status_t smart_msgqueue_send_timeout(smart_msgqueue_t *queue, const smart_msg_t *msg,
+                                                uint32_t timeout_ms)
 {
     if (!queue || !msg)
     {
@@ -35,28 +188,98 @@ smart_msgq_status_t smart_msgqueue_send(smart_msgqueue_t *queue, const smart_msg
     
     smart_enter_critical();
     
+    /* 已阻塞的发送者先入队，新消息不能越过它们 */
+    int woke = 0;
+    while (smart_msgqueue_admit_sender(queue))
+    {
+        woke = 1;
+    }
+    
+    /* 队列为空且有接收者在等待：直接交付，不经过缓冲区。
+     * 队列非空时必须排在已有消息之后（接收者正在接力取走它们）
+     */
+    if (queue->count == 0 && queue->recv_wait_list != NULL)
+    {
+        smart_task_t receiver = queue->recv_wait_list;
+        *(smart_msg_t *)receiver->wait_obj = *msg;
+#if SMART_MSGQ_STATS
+        ((smart_msg_t *)receiver->wait_obj)->timestamp = smart_get_cycles();
+#endif
+        smart_task_wakeup(receiver, SMART_WAIT_OK);
+        smart_schedule();
+        
+        smart_exit_critical();
+        return SMART_MSGQ_OK;
+    }
+    
     /* 检查队列是否已满 */
     if (queue->count >= queue->capacity)
     {
-        queue->dropped++;
+        smart_task_t current = smart_get_current_task();
+        if (timeout_ms == 0 || !current)
+        {
+            queue->dropped++;
+            if (woke)
+            {
+                smart_schedule();
+            }
+            smart_exit_critical();
+            return SMART_MSGQ_FULL;
+        }
+        
+        /* 阻塞等待，接收方取走消息后会把本消息直接写入队尾 */
+        current->wait_obj = (void *)msg;
+#if SMART_MSGQ_STATS
+        current->wait_value = smart_get_cycles();  /* 延迟从首次尝试发送算起 */
+#endif
+        uint8_t result = smart_task_block(&queue->send_wait_list, timeout_ms);
+        current->wait_obj = NULL;
+        
+        /* 接力：仍有空位时放入下一个等待发送者 */
+        if (smart_msgqueue_admit_sender(queue))
+        {
+            smart_schedule();
+        }
+        
+        if (result != SMART_WAIT_OK)
+        {
+            queue->dropped++;
+            smart_exit_critical();
+            return SMART_MSGQ_TIMEOUT;
+        }
+        
         smart_exit_critical();
-        return SMART_MSGQ_FULL;
+        return SMART_MSGQ_OK;
     }
     
     /* 复制消息到队尾 */
     queue->buffer[queue->tail] = *msg;
+#if SMART_MSGQ_STATS
+    queue->buffer[queue->tail].timestamp = smart_get_cycles();
+#endif
     
     /* 更新队尾指针（环形缓冲区） */
     queue->tail = (queue->tail + 1) % queue->capacity;
     queue->count++;
+#if SMART_MSGQ_STATS
+    smart_msgqueue_note_depth(queue);
+#endif
+    
+    /* 队列原本非空而接收者在等待：交出队头，保持先进先出 */
+    woke |= smart_msgqueue_feed_receiver(queue);
+    if (woke)
+    {
+        smart_schedule();
+    }
     
     smart_exit_critical();
     
     return SMART_MSGQ_OK;
 }
 
-/* 接收消息（非阻塞） */
-smart_msgq_status_t smart_msgqueue_receive(smart_msgqueue_t *queue, smart_msg_t *msg)
+/* 接收消息（带超时） */
+smart_msgq_status_t smart_msgqueue_receive_timeout(smart_msgqueue_t *queue, smart_msg_t *msg,
+                                                   uint32_t timeout_ms)
 {
     if (!queue || !msg)
     {
@@ -68,22 +291,619 @@ smart_msgq_status_t smart_msgqueue_receive(smart_msgqueue_t *queue, smart_msg_t
     /* 检查队列是否为空 */
     if (queue->count == 0)
     {
+        smart_task_t current = smart_get_current_task();
+        if (timeout_ms == 0 || !current)
+        {
+            smart_exit_critical();
+            return SMART_MSGQ_EMPTY;
+        }
+        
+        /* 阻塞等待，发送方直接把消息写入 msg */
+        current->wait_obj = msg;
+        uint8_t result = smart_task_block(&queue->recv_wait_list, timeout_ms);
+        current->wait_obj = NULL;
+        
+#if SMART_MSGQ_STATS
+        if (result == SMART_WAIT_OK)
+        {
+            smart_msgqueue_note_latency(queue, msg);
+        }
+#endif
+        /* 接力：批量发送只唤醒了一个接收者，队列仍非空时交给下一个 */
+        if (smart_msgqueue_feed_receiver(queue))
+        {
+            smart_schedule();
+        }
         smart_exit_critical();
-        return SMART_MSGQ_EMPTY;
+        return (result == SMART_WAIT_OK) ? SMART_MSGQ_OK : SMART_MSGQ_TIMEOUT;
     }
     
     /* 从队头取出消息 */
     *msg = queue->buffer[queue->head];
+#if SMART_MSGQ_STATS
+    smart_msgqueue_note_latency(queue, msg);
+#endif
     
     /* 更新队头指针（环形缓冲区） */
     queue->head = (queue->head + 1) % queue->capacity;
     queue->count--;
     
+    /* 腾出空间后，把最紧急发送者的消息补入队尾并唤醒它；
+     * 仍有消息且有其他接收者在等待时交出队头
+     */
+    int woke = smart_msgqueue_admit_sender(queue);
+    woke |= smart_msgqueue_feed_receiver(queue);
+    if (woke)
+    {
+        smart_schedule();
+    }
+    
+    smart_exit_critical();
+    
+    return SMART_MSGQ_OK;
+}
+
+/* ========== 批量收发 ========== */
+
+/* 批量发送（非阻塞），返回实际发送的消息数 */
+uint32_t smart_msgqueue_send_n(smart_msgqueue_t *queue, const smart_msg_t *msgs, uint32_t n)
+{
+    if (!queue || !msgs || n == 0)
+    {
+        return 0;
+    }
+    
+    smart_enter_critical();
+    
+    /* 已阻塞的发送者先入队 */
+    int woke = 0;
+    while (smart_msgqueue_admit_sender(queue))
+    {
+        woke = 1;
+    }
+    
+    uint32_t sent = n;
+    uint32_t space = queue->capacity - queue->count;
+    if (sent > space)
+    {
+        sent = space;
+    }
+    
+    if (sent > 0)
+    {
+#if SMART_MSGQ_STATS
+        uint32_t first_slot = queue->tail;
+#endif
+        smart_msgqueue_copy_in(queue, msgs, sent);
+#if SMART_MSGQ_STATS
+        smart_msgqueue_stamp(queue, first_slot, sent, smart_get_cycles());
+        smart_msgqueue_note_depth(queue);
+#endif
+    }
+    
+    queue->dropped += n - sent;
+    
+    /* 整批只唤醒一个接收者（交出队头）、只触发一次调度，其余接收者由它接力唤醒 */
+    woke |= smart_msgqueue_feed_receiver(queue);
+    if (woke)
+    {
+        smart_schedule();
+    }
+    
+    smart_exit_critical();
+    
+    return sent;
+}
+
+/* 批量接收（非阻塞），返回实际接收的消息数 */
+uint32_t smart_msgqueue_receive_n(smart_msgqueue_t *queue, smart_msg_t *msgs, uint32_t max_count)
+{
+    if (!queue || !msgs || max_count == 0)
+    {
+        return 0;
+    }
+    
+    smart_enter_critical();
+    
+    uint32_t batch = (queue->count < max_count) ? queue->count : max_count;
+    if (batch > 0)
+    {
+        smart_msgqueue_copy_out(queue, msgs, batch);
+#if SMART_MSGQ_STATS
+        for (uint32_t i = 0; i < batch; i++)
+        {
+            smart_msgqueue_note_latency(queue, &msgs[i]);
+        }
+#endif
+        
+        /* 整批只唤醒一个发送者：把最紧急发送者的消息补入队尾，其余发送者由它接力放入；
+         * 在此之前到来的新发送者会先放入等待者，不会越过它们
+         */
+        if (smart_msgqueue_admit_sender(queue))
+        {
+            smart_schedule();
+        }
+    }
+    
     smart_exit_critical();
     
+    return batch;
+}
+
+/* ========== 零拷贝消息 ========== */
+
+static smart_msg_block_t *smart_msg_block_of(void *payload)
+{
+    return (smart_msg_block_t *)((uint8_t *)payload - sizeof(smart_msg_block_t));
+}
+
+void *smart_msg_alloc(smart_mempool_t *pool, uint32_t *capacity)
+{
+    if (!pool || pool->block_size <= sizeof(smart_msg_block_t))
+    {
+        return NULL;
+    }
+    
+    void *raw = NULL;
+    if (smart_mempool_alloc_try(pool, &raw) != SMART_MEMPOOL_OK)
+    {
+        return NULL;
+    }
+    
+    smart_msg_block_t *block = (smart_msg_block_t *)raw;
+    block->pool = pool;
+    block->refcount = 1;
+    block->length = 0;
+    
+    if (capacity)
+    {
+        *capacity = pool->block_size - sizeof(smart_msg_block_t);
+    }
+    
+    return block + 1;
+}
+
+void smart_msg_ref(void *payload)
+{
+    if (!payload)
+    {
+        return;
+    }
+    
+    smart_atomic_inc(&smart_msg_block_of(payload)->refcount);
+}
+
+void smart_msg_release(void *payload)
+{
+    if (!payload)
+    {
+        return;
+    }
+    
+    smart_msg_block_t *block = smart_msg_block_of(payload);
+    if (smart_atomic_dec(&block->refcount) != 0)
+    {
+        return;
+    }
+    
+    /* 最后一个引用：归还内存池。可能在中断中或临界路径上，不消耗令牌、不等待 */
+    smart_mempool_free_unthrottled(block->pool, block);
+}
+
+smart_msgq_status_t smart_msgqueue_send_ref(smart_msgqueue_t *queue, uint32_t type,
+                                            void *payload, uint32_t length,
+                                            uint32_t timeout_ms)
+{
+    if (!payload)
+    {
+        return SMART_MSGQ_INVALID;
+    }
+    
+    smart_msg_t msg;
+    msg.type = type;
+    msg.data = length;
+    msg.ptr = payload;
+    smart_msg_block_of(payload)->length = length;
+    
+    return smart_msgqueue_send_timeout(queue, &msg, timeout_ms);
+}
+
+uint32_t smart_msgqueue_multicast_ref(smart_msgqueue_t **queues, uint32_t queue_count,
+                                      uint32_t type, void *payload, uint32_t length)
+{
+    if (!queues || !payload)
+    {
+        return 0;
+    }
+    
+    uint32_t delivered = 0;
+    
+    for (uint32_t i = 0; i < queue_count; i++)
+    {
+        /* 先为接收者加引用，投递失败再撤销 */
+        smart_msg_ref(payload);
+        if (smart_msgqueue_send_ref(queues[i], type, payload, length, 0) == SMART_MSGQ_OK)
+        {
+            delivered++;
+        }
+        else
+        {
+            smart_msg_release(payload);
+        }
+    }
+    
+    /* 消耗调用者自己的引用 */
+    smart_msg_release(payload);
+    
+    return delivered;
+}
+
+/* ========== 单生产者/单消费者无锁队列 ========== */
+
+smart_msgq_status_t smart_spsc_msgqueue_init(smart_spsc_msgqueue_t *queue, smart_msg_t *buffer,
+                                             uint32_t capacity)
+{
+    if (!queue || !buffer || smart_spsc_index_init(&queue->index, capacity) != 0)
+    {
+        return SMART_MSGQ_INVALID;
+    }
+    
+    queue->buffer = buffer;
+    queue->dropped = 0;
+    
     return SMART_MSGQ_OK;
 }
 
+smart_msgq_status_t smart_spsc_msgqueue_send(smart_spsc_msgqueue_t *queue, const smart_msg_t *msg)
+{
+    uint32_t slot;
+    
+    if (!smart_spsc_write_slot(&queue->index, &slot))
+    {
+        queue->dropped++;
+        return SMART_MSGQ_FULL;
+    }
+    
+    queue->buffer[slot] = *msg;
+    smart_spsc_write_commit(&queue->index);
+    
+    return SMART_MSGQ_OK;
+}
+
+smart_msgq_status_t smart_spsc_msgqueue_receive(smart_spsc_msgqueue_t *queue, smart_msg_t *msg)
+{
+    uint32_t slot;
+    
+    if (!smart_spsc_read_slot(&queue->index, &slot))
+    {
+        return SMART_MSGQ_EMPTY;
+    }
+    
+    *msg = queue->buffer[slot];
+    smart_spsc_read_commit(&queue->index);
+    
+    return SMART_MSGQ_OK;
+}
+
+uint32_t smart_spsc_msgqueue_count(const smart_spsc_msgqueue_t *queue)
+{
+    if (!queue)
+    {
+        return 0;
+    }
+    
+    return smart_spsc_index_count(&queue->index);
+}
+
+/* ========== 优先级消息队列 ========== */
+
+#define PRIO_LANE_BIT(lane)  (0x80000000u >> (lane))
+
+void smart_prio_msgqueue_init(smart_prio_msgqueue_t *queue, smart_msg_t *buffer,
+                              uint32_t lane_capacity)
+{
+    if (!queue || !buffer || lane_capacity == 0)
+    {
+        return;
+    }
+    
+    smart_enter_critical();
+    
+    /* 注册关系（name/next_registered）保持不变 */
+    queue->buffer = buffer;
+    queue->lane_capacity = lane_capacity;
+    memset(queue->head, 0, sizeof(queue->head));
+    memset(queue->count, 0, sizeof(queue->count));
+    queue->bitmap = 0;
+    memset(queue->stats, 0, sizeof(queue->stats));
+    queue->recv_wait_list = NULL;
+    
+    smart_exit_critical();
+}
+
+smart_msgq_status_t smart_prio_msgqueue_send(smart_prio_msgqueue_t *queue, const smart_msg_t *msg,
+                                             uint32_t lane)
+{
+    if (!queue || !msg || lane >= SMART_MSGQ_PRIO_LANES)
+    {
+        return SMART_MSGQ_INVALID;
+    }
+    
+    smart_msgq_lane_stats_t *stats = &queue->stats[lane];
+    
+    smart_enter_critical();
+    
+    /* 有接收者在等待（此时所有通道为空）：直接交付 */
+    if (queue->recv_wait_list != NULL)
+    {
+        smart_task_t receiver = queue->recv_wait_list;
+        *(smart_msg_t *)receiver->wait_obj = *msg;
+        receiver->wait_value = lane;
+        stats->enqueued++;
+        smart_task_wakeup(receiver, SMART_WAIT_OK);
+        smart_schedule();
+        
+        smart_exit_critical();
+        return SMART_MSGQ_OK;
+    }
+    
+    uint32_t count = queue->count[lane];
+    if (count >= queue->lane_capacity)
+    {
+        stats->dropped++;
+        smart_exit_critical();
+        return SMART_MSGQ_FULL;
+    }
+    
+    uint32_t slot = queue->head[lane] + count;
+    if (slot >= queue->lane_capacity)
+    {
+        slot -= queue->lane_capacity;
+    }
+    queue->buffer[lane * queue->lane_capacity + slot] = *msg;
+    
+    queue->count[lane] = ++count;
+    queue->bitmap |= PRIO_LANE_BIT(lane);
+    stats->enqueued++;
+    if (count > stats->max_depth)
+    {
+        stats->max_depth = count;
+    }
+    
+    smart_exit_critical();
+    
+    return SMART_MSGQ_OK;
+}
+
+smart_msgq_status_t smart_prio_msgqueue_receive(smart_prio_msgqueue_t *queue, smart_msg_t *msg,
+                                                uint32_t *lane, uint32_t timeout_ms)
+{
+    if (!queue || !msg)
+    {
+        return SMART_MSGQ_INVALID;
+    }
+    
+    smart_enter_critical();
+    
+    if (queue->bitmap == 0)
+    {
+        smart_task_t current = smart_get_current_task();
+        if (timeout_ms == 0 || !current)
+        {
+            smart_exit_critical();
+            return SMART_MSGQ_EMPTY;
+        }
+        
+        /* 阻塞等待，发送方直接写入 msg 并在 wait_value 中记录通道 */
+        current->wait_obj = msg;
+        uint8_t result = smart_task_block(&queue->recv_wait_list, timeout_ms);
+        current->wait_obj = NULL;
+        
+        if (result == SMART_WAIT_OK && lane)
+        {
+            *lane = current->wait_value;
+        }
+        
+        smart_exit_critical();
+        return (result == SMART_WAIT_OK) ? SMART_MSGQ_OK : SMART_MSGQ_TIMEOUT;
+    }
+    
+    /* 最高位对应最紧急的非空通道 */
+    uint32_t best = (uint32_t)__builtin_clz(queue->bitmap);
+    uint32_t head = queue->head[best];
+    
+    *msg = queue->buffer[best * queue->lane_capacity + head];
+    
+    head++;
+    if (head >= queue->lane_capacity)
+    {
+        head = 0;
+    }
+    queue->head[best] = head;
+    
+    if (--queue->count[best] == 0)
+    {
+        queue->bitmap &= ~PRIO_LANE_BIT(best);
+    }
+    
+    smart_exit_critical();
+    
+    if (lane)
+    {
+        *lane = best;
+    }
+    
+    return SMART_MSGQ_OK;
+}
+
+smart_msgq_status_t smart_prio_msgqueue_get_stats(const smart_prio_msgqueue_t *queue, uint32_t lane,
+                                                  smart_msgq_lane_stats_t *stats)
+{
+    if (!queue || !stats || lane >= SMART_MSGQ_PRIO_LANES)
+    {
+        return SMART_MSGQ_INVALID;
+    }
+    
+    smart_enter_critical();
+    *stats = queue->stats[lane];
+    smart_exit_critical();
+    
+    return SMART_MSGQ_OK;
+}
+
+uint32_t smart_prio_msgqueue_count(const smart_prio_msgqueue_t *queue)
+{
+    if (!queue)
+    {
+        return 0;
+    }
+    
+    uint32_t total = 0;
+    for (uint32_t lane = 0; lane < SMART_MSGQ_PRIO_LANES; lane++)
+    {
+        total += queue->count[lane];
+    }
+    
+    return total;
+}
+
+/* ========== 队列注册与统计 ========== */
+
+void smart_msgqueue_register(smart_msgqueue_t *queue, const char *name)
+{
+    if (!queue)
+    {
+        return;
+    }
+    
+    smart_enter_critical();
+    
+    queue->name = name;
+    
+    smart_msgqueue_t *q = msgqueue_registry;
+    while (q && q != queue)
+    {
+        q = q->next_registered;
+    }
+    if (!q)
+    {
+        queue->next_registered = msgqueue_registry;
+        msgqueue_registry = queue;
+    }
+    
+    smart_exit_critical();
+}
+
+void smart_msgqueue_unregister(smart_msgqueue_t *queue)
+{
+    if (!queue)
+    {
+        return;
+    }
+    
+    smart_enter_critical();
+    
+    smart_msgqueue_t **link = &msgqueue_registry;
+    while (*link && *link != queue)
+    {
+        link = &(*link)->next_registered;
+    }
+    if (*link)
+    {
+        *link = queue->next_registered;
+    }
+    queue->next_registered = NULL;
+    
+    smart_exit_critical();
+}
+
+void smart_prio_msgqueue_register(smart_prio_msgqueue_t *queue, const char *name)
+{
+    if (!queue)
+    {
+        return;
+    }
+    
+    smart_enter_critical();
+    
+    queue->name = name;
+    
+    smart_prio_msgqueue_t *q = prio_msgqueue_registry;
+    while (q && q != queue)
+    {
+        q = q->next_registered;
+    }
+    if (!q)
+    {
+        queue->next_registered = prio_msgqueue_registry;
+        prio_msgqueue_registry = queue;
+    }
+    
+    smart_exit_critical();
+}
+
+void smart_prio_msgqueue_unregister(smart_prio_msgqueue_t *queue)
+{
+    if (!queue)
+    {
+        return;
+    }
+    
+    smart_enter_critical();
+    
+    smart_prio_msgqueue_t **link = &prio_msgqueue_registry;
+    while (*link && *link != queue)
+    {
+        link = &(*link)->next_registered;
+    }
+    if (*link)
+    {
+        *link = queue->next_registered;
+    }
+    queue->next_registered = NULL;
+    
+    smart_exit_critical();
+}
+
+smart_msgqueue_t *smart_msgqueue_next_registered(smart_msgqueue_t *queue)
+{
+    return queue ? queue->next_registered : msgqueue_registry;
+}
+
+smart_prio_msgqueue_t *smart_prio_msgqueue_next_registered(smart_prio_msgqueue_t *queue)
+{
+    return queue ? queue->next_registered : prio_msgqueue_registry;
+}
+
+#if SMART_MSGQ_STATS
+smart_msgq_status_t smart_msgqueue_get_stats(const smart_msgqueue_t *queue, smart_msgq_stats_t *stats)
+{
+    if (!queue || !stats)
+    {
+        return SMART_MSGQ_INVALID;
+    }
+    
+    smart_enter_critical();
+    *stats = queue->stats;
+    smart_exit_critical();
+    
+    return SMART_MSGQ_OK;
+}
+
+void smart_msgqueue_reset_stats(smart_msgqueue_t *queue)
+{
+    if (!queue)
+    {
+        return;
+    }
+    
+    smart_enter_critical();
+    memset(&queue->stats, 0, sizeof(queue->stats));
+    queue->stats.high_water = queue->count;
+    smart_exit_critical();
+}
+#endif
+
 /* 查询队列中的消息数量 */
 uint32_t smart_msgqueue_count(const smart_msgqueue_t *queue)
 {
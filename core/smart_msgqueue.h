@@ -3,6 +3,19 @@
 
 #include <stdint.h>
 #include <stddef.h>
+#include "smart_core.h"
+#include "smart_mempool.h"
+#include "smart_atomic.h"
+
+/* 队列统计：水位线、深度直方图、入队到出队延迟（消息增加一个时间戳字段）。
+ * 默认关闭：每次收发都要读周期计数器并更新统计，需要时用 -DSMART_MSGQ_STATS=1 打开。
+ */
+#ifndef SMART_MSGQ_STATS
+#define SMART_MSGQ_STATS 0
+#endif
+
+/* 深度直方图分档数（按容量等分） */
+#define SMART_MSGQ_HIST_BINS 4
 
 /* 消息队列状态 */
 typedef enum
@@ -10,7 +23,8 @@ typedef enum
     SMART_MSGQ_OK = 0,
     SMART_MSGQ_FULL,
     SMART_MSGQ_EMPTY,
-    SMART_MSGQ_INVALID
+    SMART_MSGQ_INVALID,
+    SMART_MSGQ_TIMEOUT
 } smart_msgq_status_t;
 
 /* 消息结构 */
@@ -19,10 +33,23 @@ typedef struct
     uint32_t type;      /* 消息类型 */
     uint32_t data;      /* 消息数据 */
     void *ptr;          /* 可选指针 */
+#if SMART_MSGQ_STATS
+    uint32_t timestamp; /* 发送时刻（CPU 周期），由队列填写 */
+#endif
 } smart_msg_t;
 
-/* 消息队列控制块 */
+/* 队列统计 */
 typedef struct
+{
+    uint32_t high_water;                        /* 最大深度 */
+    uint32_t depth_hist[SMART_MSGQ_HIST_BINS];  /* 入队后深度分布 */
+    uint32_t latency_samples;                   /* 延迟样本数 */
+    uint32_t latency_avg;                       /* 平均延迟（周期，指数移动平均） */
+    uint32_t latency_max;                       /* 最大延迟（周期） */
+} smart_msgq_stats_t;
+
+/* 消息队列控制块 */
+typedef struct smart_msgqueue
 {
     smart_msg_t *buffer;    /* 消息缓冲区 */
     uint32_t capacity;      /* 队列容量 */
@@ -30,6 +57,13 @@ typedef struct
     uint32_t head;          /* 队头索引 */
     uint32_t tail;          /* 队尾索引 */
     uint32_t dropped;       /* 丢弃消息计数 */
+    smart_task_t send_wait_list;  /* 队列满时阻塞的发送者（按deadline排序） */
+    smart_task_t recv_wait_list;  /* 队列空时阻塞的接收者（按deadline排序） */
+#if SMART_MSGQ_STATS
+    smart_msgq_stats_t stats;     /* 统计信息 */
+#endif
+    const char *name;             /* 注册名（smart_msgqueue_register） */
+    struct smart_msgqueue *next_registered;
 } smart_msgqueue_t;
 
 /* 初始化消息队列 */
@@ -41,6 +75,158 @@ smart_msgq_status_t smart_msgqueue_send(smart_msgqueue_t *queue, const smart_msg
 /* 接收消息（非阻塞） */
 smart_msgq_status_t smart_msgqueue_receive(smart_msgqueue_t *queue, smart_msg_t *msg);
 
+/* 发送消息（队列满时最多阻塞 timeout_ms，SMART_WAIT_FOREVER 永久等待）
+ * 有接收者等待时消息直接交给最紧急的接收者；中断中只能使用 timeout_ms=0
+ */
+smart_msgq_status_t smart_msgqueue_send_timeout(smart_msgqueue_t *queue, const smart_msg_t *msg,
+                                                uint32_t timeout_ms);
+
+/* 接收消息（队列空时最多阻塞 timeout_ms，SMART_WAIT_FOREVER 永久等待）
+ * 取走消息后把最紧急发送者的消息直接补入队尾
+ */
+smart_msgq_status_t smart_msgqueue_receive_timeout(smart_msgqueue_t *queue, smart_msg_t *msg,
+                                                   uint32_t timeout_ms);
+
+/* 批量发送（非阻塞）：一次临界区内写入最多 n 条消息，环绕时分两段拷贝
+ * 有接收者等待时第一条直接交给它；整批最多唤醒一个等待者
+ * 返回实际发送数，未能发送的计入 dropped
+ */
+uint32_t smart_msgqueue_send_n(smart_msgqueue_t *queue, const smart_msg_t *msgs, uint32_t n);
+
+/* 批量接收（非阻塞）：一次临界区内取出最多 max_count 条消息
+ * 整批最多把一个阻塞发送者的消息补入队尾；返回实际接收数
+ */
+uint32_t smart_msgqueue_receive_n(smart_msgqueue_t *queue, smart_msg_t *msgs, uint32_t max_count);
+
+/* ========== 零拷贝消息 ==========
+ * 载荷位于内存池块中，块首部记录所属内存池和引用计数。
+ * 发送时 msg.ptr 指向载荷、msg.data 为长度；接收者用完后调用 smart_msg_release。
+ */
+typedef struct
+{
+    smart_mempool_t *pool;          /* 所属内存池 */
+    volatile uint32_t refcount;     /* 引用计数 */
+    uint32_t length;                /* 载荷有效长度 */
+} smart_msg_block_t;
+
+/* 从内存池分配载荷（引用计数为 1），capacity 返回可用载荷字节数，可为 NULL */
+void *smart_msg_alloc(smart_mempool_t *pool, uint32_t *capacity);
+
+/* 增加引用（多播前为每个额外接收者调用） */
+void smart_msg_ref(void *payload);
+
+/* 释放一个引用，归零时归还内存池（不受限流影响，不阻塞，可在中断中调用） */
+void smart_msg_release(void *payload);
+
+/* 发送载荷引用：成功时调用者的引用转移给接收者，失败时仍归调用者所有 */
+smart_msgq_status_t smart_msgqueue_send_ref(smart_msgqueue_t *queue, uint32_t type,
+                                            void *payload, uint32_t length,
+                                            uint32_t timeout_ms);
+
+/* 多播：每个队列各持有一个引用，调用者自己的引用在返回时被消耗
+ * 返回成功投递的队列数
+ */
+uint32_t smart_msgqueue_multicast_ref(smart_msgqueue_t **queues, uint32_t queue_count,
+                                      uint32_t type, void *payload, uint32_t length);
+
+/* ========== 单生产者/单消费者无锁队列 ==========
+ * 容量为 2 的幂，索引由 smart_spsc_index_t 管理（见 smart_atomic.h），
+ * 收发都不关中断，适合一个中断向一个任务投递消息。
+ */
+typedef struct
+{
+    smart_msg_t *buffer;        /* 消息缓冲区 */
+    smart_spsc_index_t index;
+    uint32_t dropped;           /* 丢弃消息计数（生产者写） */
+} smart_spsc_msgqueue_t;
+
+/* 初始化（capacity 必须为 2 的幂） */
+smart_msgq_status_t smart_spsc_msgqueue_init(smart_spsc_msgqueue_t *queue, smart_msg_t *buffer,
+                                             uint32_t capacity);
+
+/* 生产者发送（非阻塞） */
+smart_msgq_status_t smart_spsc_msgqueue_send(smart_spsc_msgqueue_t *queue, const smart_msg_t *msg);
+
+/* 消费者接收（非阻塞） */
+smart_msgq_status_t smart_spsc_msgqueue_receive(smart_spsc_msgqueue_t *queue, smart_msg_t *msg);
+
+/* 当前消息数量 */
+uint32_t smart_spsc_msgqueue_count(const smart_spsc_msgqueue_t *queue);
+
+/* ========== 优先级消息队列 ==========
+ * 固定数量的优先级通道（0 最紧急），每个通道是独立的环形缓冲区；
+ * 非空通道记录在位图中，用 CLZ 指令 O(1) 找到最紧急的通道，
+ * 接收者总是先拿到紧急消息，控制消息不会排在批量数据之后。
+ */
+#ifndef SMART_MSGQ_PRIO_LANES
+#define SMART_MSGQ_PRIO_LANES 4
+#endif
+
+#if SMART_MSGQ_PRIO_LANES > 32
+#error "SMART_MSGQ_PRIO_LANES must not exceed 32 (bitmap width)"
+#endif
+
+/* 通道统计 */
+typedef struct
+{
+    uint32_t enqueued;      /* 入队消息数 */
+    uint32_t dropped;       /* 通道满丢弃数 */
+    uint32_t max_depth;     /* 最大深度 */
+} smart_msgq_lane_stats_t;
+
+typedef struct smart_prio_msgqueue
+{
+    smart_msg_t *buffer;            /* lane_capacity * SMART_MSGQ_PRIO_LANES 条消息 */
+    uint32_t lane_capacity;         /* 每个通道容量 */
+    uint32_t head[SMART_MSGQ_PRIO_LANES];
+    uint32_t count[SMART_MSGQ_PRIO_LANES];
+    uint32_t bitmap;                /* 第 31-lane 位表示通道非空 */
+    smart_msgq_lane_stats_t stats[SMART_MSGQ_PRIO_LANES];
+    smart_task_t recv_wait_list;    /* 全部通道为空时阻塞的接收者 */
+    const char *name;               /* 注册名（smart_prio_msgqueue_register） */
+    struct smart_prio_msgqueue *next_registered;
+} smart_prio_msgqueue_t;
+
+/* 初始化（buffer 需容纳 lane_capacity * SMART_MSGQ_PRIO_LANES 条消息） */
+void smart_prio_msgqueue_init(smart_prio_msgqueue_t *queue, smart_msg_t *buffer,
+                              uint32_t lane_capacity);
+
+/* 发送到指定通道（非阻塞，中断可用）；有接收者等待时直接交付 */
+smart_msgq_status_t smart_prio_msgqueue_send(smart_prio_msgqueue_t *queue, const smart_msg_t *msg,
+                                             uint32_t lane);
+
+/* 从最紧急的非空通道接收，全部为空时最多阻塞 timeout_ms；lane 可为 NULL */
+smart_msgq_status_t smart_prio_msgqueue_receive(smart_prio_msgqueue_t *queue, smart_msg_t *msg,
+                                                uint32_t *lane, uint32_t timeout_ms);
+
+/* 读取通道统计 */
+smart_msgq_status_t smart_prio_msgqueue_get_stats(const smart_prio_msgqueue_t *queue, uint32_t lane,
+                                                  smart_msgq_lane_stats_t *stats);
+
+/* 全部通道的消息总数 */
+uint32_t smart_prio_msgqueue_count(const smart_prio_msgqueue_t *queue);
+
+/* ========== 队列注册与统计 ==========
+ * 注册后的队列由 shell 'mq' 命令列出；重复注册只更新名称，
+ * 重新 init 不影响注册关系（init 会清零统计）。
+ */
+void smart_msgqueue_register(smart_msgqueue_t *queue, const char *name);
+void smart_msgqueue_unregister(smart_msgqueue_t *queue);
+void smart_prio_msgqueue_register(smart_prio_msgqueue_t *queue, const char *name);
+void smart_prio_msgqueue_unregister(smart_prio_msgqueue_t *queue);
+
+/* 遍历注册表，从 NULL 开始 */
+smart_msgqueue_t *smart_msgqueue_next_registered(smart_msgqueue_t *queue);
+smart_prio_msgqueue_t *smart_prio_msgqueue_next_registered(smart_prio_msgqueue_t *queue);
+
+#if SMART_MSGQ_STATS
+/* 读取统计快照 */
+smart_msgq_status_t smart_msgqueue_get_stats(const smart_msgqueue_t *queue, smart_msgq_stats_t *stats);
+
+/* 清零统计 */
+void smart_msgqueue_reset_stats(smart_msgqueue_t *queue);
+#endif
+
 /* 查询队列状态 */
 uint32_t smart_msgqueue_count(const smart_msgqueue_t *queue);
 uint32_t smart_msgqueue_space(const smart_msgqueue_t *queue);
@@ -2,10 +2,16 @@
 #include "smart_core.h"
 #include "smart_uart.h"
 #include "smart_mempool.h"
+#include "smart_arena.h"
+#include "smart_malloc.h"
+#include "smart_heap.h"
 #include "smart_fs.h"
 #include "smart_msgqueue.h"
+#include "smart_msgbuf.h"
+#include "smart_topic.h"
 #include "smart_sync.h"
 #include "smart_timer.h"
+#include "smart_memmap.h"
 #include "../user/snake_game.h"
 #include <string.h>
 
@@ -44,6 +50,13 @@ static int cmd_uartinfo(int argc, char *argv[]);
 static int cmd_test(int argc, char *argv[]);
 static int cmd_stress(int argc, char *argv[]);
 static int cmd_timer(int argc, char *argv[]);
+static int cmd_bench(int argc, char *argv[]);
+static int cmd_critinfo(int argc, char *argv[]);
+static int cmd_topic(int argc, char *argv[]);
+static int cmd_mq(int argc, char *argv[]);
+#if SMART_MEMPOOL_DEBUG
+static int cmd_memdbg(int argc, char *argv[]);
+#endif
 
 /* 命令表 */
 typedef struct {
@@ -70,11 +83,18 @@ static const shell_command_t shell_commands[] = {
     {"stats",   "Task statistics & AI",     "stats",                 cmd_stats},
     {"msgtest", "Message queue test",       "msgtest",               cmd_msgtest},
     {"snake",   "Play Snake game",          "snake",                 cmd_snake},
-    {"synctest","Semaphore & Mutex test",   "synctest",              cmd_synctest},
+    {"synctest","Sync primitives test",     "synctest",              cmd_synctest},
     {"uartinfo","UART interrupt stats",     "uartinfo",              cmd_uartinfo},
     {"test",    "Run system tests",         "test [all|mem|fs|sync|perf]", cmd_test},
     {"stress",  "Run stress tests",         "stress",                cmd_stress},
     {"timer",   "Software timer test",      "timer [list|test]",     cmd_timer},
+    {"bench",   "Kernel micro-benchmarks",  "bench [sem|mq|pool]",   cmd_bench},
+    {"critinfo","Critical section stats",   "critinfo [reset]",      cmd_critinfo},
+    {"topic",   "List pub/sub topics",      "topic",                 cmd_topic},
+    {"mq",      "Message queue statistics", "mq [reset]",            cmd_mq},
+#if SMART_MEMPOOL_DEBUG
+    {"memdbg",  "Outstanding pool blocks",  "memdbg",                cmd_memdbg},
+#endif
     {NULL,      NULL,                       NULL,                    NULL}
 };
 
@@ -151,7 +171,13 @@ static int cmd_ps(int argc, char *argv[])
     (void)argc;
     (void)argv;
     
-    smart_task_info_t tasks[10];
+    SMART_ARENA_SCOPE(&smart_scratch);
+    smart_task_info_t *tasks = (smart_task_info_t *)smart_arena_alloc(&smart_scratch,
+                                                                       10 * sizeof(smart_task_info_t));
+    if (!tasks) {
+        smart_uart_print("Error: scratch memory busy\n");
+        return -1;
+    }
     int count = smart_get_task_list(tasks, 10);
     
     smart_uart_print("\nTask List:\n");
@@ -160,7 +186,7 @@ static int cmd_ps(int argc, char *argv[])
     smart_uart_print("-------------------------------------------------------------------------\n");
     
     const char *state_names[] = {
-        "INIT ", "READY", "RUN  ", "WAIT ", "SUSP ", "DELAY"
+        "INIT ", "READY", "RUN  ", "WAIT ", "SUSP ", "DELAY", "BLOCK"
     };
     
     for (int i = 0; i < count; i++)
@@ -171,7 +197,7 @@ static int cmd_ps(int argc, char *argv[])
         smart_uart_print(" ");
         
         /* State */
-        if (tasks[i].state < 6)
+        if (tasks[i].state < 7)
         {
             smart_uart_print(state_names[tasks[i].state]);
         }
@@ -230,54 +256,143 @@ static int cmd_meminfo(int argc, char *argv[])
     (void)argc;
     (void)argv;
     
-    smart_mempool_t *pool = smart_get_mempool();
-    if (!pool)
+    /* 链接脚本划分的各段 */
+    smart_memregion_t regions[8];
+    uint32_t region_count = smart_memmap_get(regions, 8);
+    
+    smart_uart_print("\nMemory regions:\n");
+    smart_uart_print("  Region      Start     Size      Limit     Used\n");
+    for (uint32_t i = 0; i < region_count; i++)
     {
-        smart_uart_print("\nError: Memory pool not available\n\n");
-        return -1;
+        smart_uart_print("  ");
+        smart_uart_print(regions[i].name);
+        for (size_t pad = strlen(regions[i].name); pad < 10; pad++)
+        {
+            smart_uart_print(" ");
+        }
+        smart_uart_print("  ");
+        smart_uart_print_hex32(regions[i].start);
+        smart_uart_print("  ");
+        smart_uart_print_hex32(regions[i].size);
+        smart_uart_print("  ");
+        smart_uart_print_hex32(regions[i].limit);
+        smart_uart_print("  ");
+        smart_uart_print_hex32(regions[i].used);
+        smart_uart_print("\n");
     }
     
-    smart_mempool_stats_t stats;
-    smart_mempool_get_stats(pool, &stats);
+    smart_uart_print("\nMemory pools:\n");
+    smart_uart_print("  Name          BlkSize   Total     Free      MinFree   Used%\n");
     
-    smart_uart_print("\nMemory Pool Information:\n");
-    smart_uart_print("------------------------\n");
-    
-    smart_uart_print("Block size:      ");
-    smart_uart_print_hex32(stats.block_size);
-    smart_uart_print(" bytes\n");
-    
-    smart_uart_print("Total blocks:    ");
-    smart_uart_print_hex32(stats.block_count);
-    smart_uart_print("\n");
-    
-    smart_uart_print("Free blocks:     ");
-    smart_uart_print_hex32(stats.free_count);
-    smart_uart_print("\n");
+    uint32_t total_bytes = 0;
+    uint32_t free_bytes = 0;
+    for (smart_mempool_t *pool = smart_mempool_next_registered(NULL); pool;
+         pool = smart_mempool_next_registered(pool))
+    {
+        smart_mempool_stats_t stats;
+        smart_mempool_get_stats(pool, &stats);
+        
+        const char *name = pool->name ? pool->name : "(unnamed)";
+        smart_uart_print("  ");
+        smart_uart_print(name);
+        for (size_t pad = strlen(name); pad < 12; pad++)
+        {
+            smart_uart_print(" ");
+        }
+        smart_uart_print("  ");
+        smart_uart_print_hex32(stats.block_size);
+        smart_uart_print("  ");
+        smart_uart_print_hex32(stats.block_count);
+        smart_uart_print("  ");
+        smart_uart_print_hex32(stats.free_count);
+        smart_uart_print("  ");
+        smart_uart_print_hex32(stats.min_free_count);
+        smart_uart_print("  ");
+        smart_uart_print_hex32((stats.block_count - stats.free_count) * 100u / stats.block_count);
+        smart_uart_print("\n");
+        
+        total_bytes += stats.block_size * stats.block_count;
+        free_bytes += stats.block_size * stats.free_count;
+    }
     
-    smart_uart_print("Used blocks:     ");
-    smart_uart_print_hex32(stats.block_count - stats.free_count);
-    smart_uart_print("\n");
+    smart_uart_print("  Pool memory:  ");
+    smart_uart_print_hex32(total_bytes);
+    smart_uart_print(" bytes, ");
+    smart_uart_print_hex32(total_bytes - free_bytes);
+    smart_uart_print(" used, ");
+    smart_uart_print_hex32(free_bytes);
+    smart_uart_print(" free\n");
     
-    smart_uart_print("Min free (peak): ");
-    smart_uart_print_hex32(stats.min_free_count);
-    smart_uart_print("\n");
+    /* 分级分配器 */
+    smart_uart_print("\nsmart_malloc size classes:\n");
+    smart_uart_print("  Size      Total     Free      MinFree   Allocs    Spills    Fails\n");
+    for (uint32_t i = 0; i < SMART_MALLOC_CLASSES; i++)
+    {
+        smart_malloc_class_stats_t cls;
+        if (smart_malloc_get_class_stats(i, &cls) != 0)
+        {
+            continue;
+        }
+        
+        smart_uart_print("  ");
+        smart_uart_print_hex32(cls.block_size);
+        smart_uart_print("  ");
+        smart_uart_print_hex32(cls.block_count);
+        smart_uart_print("  ");
+        smart_uart_print_hex32(cls.free_count);
+        smart_uart_print("  ");
+        smart_uart_print_hex32(cls.min_free_count);
+        smart_uart_print("  ");
+        smart_uart_print_hex32(cls.alloc_count);
+        smart_uart_print("  ");
+        smart_uart_print_hex32(cls.spill_count);
+        smart_uart_print("  ");
+        smart_uart_print_hex32(cls.fail_count);
+        smart_uart_print("\n");
+    }
     
-    uint32_t total_bytes = stats.block_size * stats.block_count;
-    uint32_t free_bytes = stats.block_size * stats.free_count;
-    uint32_t used_bytes = total_bytes - free_bytes;
+    /* TLSF 堆 */
+    smart_heap_stats_t heap_stats;
+    smart_heap_get_stats(&heap_stats);
     
-    smart_uart_print("\nTotal memory:    ");
-    smart_uart_print_hex32(total_bytes);
+    smart_uart_print("\nTLSF heap:\n");
+    smart_uart_print("  Total:         ");
+    smart_uart_print_hex32(heap_stats.total_bytes);
     smart_uart_print(" bytes\n");
-    
-    smart_uart_print("Used memory:     ");
-    smart_uart_print_hex32(used_bytes);
+    smart_uart_print("  Free:          ");
+    smart_uart_print_hex32(heap_stats.free_bytes);
+    smart_uart_print(" bytes (min ");
+    smart_uart_print_hex32(heap_stats.min_free_bytes);
+    smart_uart_print(")\n");
+    smart_uart_print("  Largest free:  ");
+    smart_uart_print_hex32(heap_stats.largest_free);
     smart_uart_print(" bytes\n");
+    smart_uart_print("  Blocks:        ");
+    smart_uart_print_hex32(heap_stats.used_blocks);
+    smart_uart_print(" used, ");
+    smart_uart_print_hex32(heap_stats.free_blocks);
+    smart_uart_print(" free\n");
+    smart_uart_print("  Fragmentation: ");
+    smart_uart_print_hex32(heap_stats.fragmentation);
+    smart_uart_print("%\n");
+    smart_uart_print("  Alloc/fail:    ");
+    smart_uart_print_hex32(heap_stats.alloc_count);
+    smart_uart_print(" / ");
+    smart_uart_print_hex32(heap_stats.fail_count);
+    smart_uart_print("\n");
     
-    smart_uart_print("Free memory:     ");
-    smart_uart_print_hex32(free_bytes);
-    smart_uart_print(" bytes\n\n");
+    /* 共享临时区域 */
+    smart_uart_print("\nScratch arena:\n");
+    smart_uart_print("  Used:          ");
+    smart_uart_print_hex32(smart_scratch.used);
+    smart_uart_print(" / ");
+    smart_uart_print_hex32(smart_scratch.size);
+    smart_uart_print(" bytes (peak ");
+    smart_uart_print_hex32(smart_scratch.high_water);
+    smart_uart_print(")\n");
+    smart_uart_print("  Failures:      ");
+    smart_uart_print_hex32(smart_scratch.fail_count);
+    smart_uart_print("\n\n");
     
     return 0;
 }
@@ -287,18 +402,17 @@ static int cmd_free(int argc, char *argv[])
     (void)argc;
     (void)argv;
     
-    smart_mempool_t *pool = smart_get_mempool();
-    if (!pool)
+    /* 汇总所有已注册的内存池 */
+    uint32_t total_bytes = 0;
+    uint32_t free_bytes = 0;
+    for (smart_mempool_t *pool = smart_mempool_next_registered(NULL); pool;
+         pool = smart_mempool_next_registered(pool))
     {
-        smart_uart_print("\nError: Memory pool not available\n\n");
-        return -1;
+        smart_mempool_stats_t stats;
+        smart_mempool_get_stats(pool, &stats);
+        total_bytes += stats.block_size * stats.block_count;
+        free_bytes += stats.block_size * stats.free_count;
     }
-    
-    smart_mempool_stats_t stats;
-    smart_mempool_get_stats(pool, &stats);
-    
-    uint32_t total_bytes = stats.block_size * stats.block_count;
-    uint32_t free_bytes = stats.block_size * stats.free_count;
     uint32_t used_bytes = total_bytes - free_bytes;
     
     smart_uart_print("\n              Total       Used       Free\n");
@@ -330,6 +444,8 @@ static int cmd_ls(int argc, char *argv[])
     return 0;
 }
 
+#define CAT_CHUNK_SIZE 128u
+
 static int cmd_cat(int argc, char *argv[])
 {
     if (argc < 2) {
@@ -347,11 +463,12 @@ static int cmd_cat(int argc, char *argv[])
     
     smart_uart_print("\n");
     
-    char buffer[128];
+    SMART_ARENA_SCOPE(&smart_scratch);
+    char *buffer = (char *)smart_arena_alloc(&smart_scratch, CAT_CHUNK_SIZE);
     uint32_t bytes_read;
     
-    while (1) {
-        status = smart_fs_read(&file, buffer, sizeof(buffer) - 1, &bytes_read);
+    while (buffer) {
+        status = smart_fs_read(&file, buffer, CAT_CHUNK_SIZE - 1, &bytes_read);
         if (status != SMART_FS_OK || bytes_read == 0) {
             break;
         }
@@ -532,7 +649,13 @@ static int cmd_stats(int argc, char *argv[])
     (void)argc;
     (void)argv;
     
-    smart_task_info_t tasks[10];
+    SMART_ARENA_SCOPE(&smart_scratch);
+    smart_task_info_t *tasks = (smart_task_info_t *)smart_arena_alloc(&smart_scratch,
+                                                                       10 * sizeof(smart_task_info_t));
+    if (!tasks) {
+        smart_uart_print("Error: scratch memory busy\n");
+        return -1;
+    }
     int count = smart_get_task_list(tasks, 10);
     
     smart_uart_print("\n=== Task Performance Analysis (AI-Powered) ===\n\n");
@@ -637,6 +760,41 @@ static int cmd_stats(int argc, char *argv[])
     return 0;
 }
 
+/* msgtest 第 11 项：阻塞接收者任务，收到一条消息后返回（任务随之结束） */
+#define MSGTEST_RX_TASKS       2
+#define MSGTEST_RX_STACK_SIZE  256u
+
+static struct smart_task msgtest_rx_task[MSGTEST_RX_TASKS];
+static volatile uint32_t msgtest_rx_type[MSGTEST_RX_TASKS];
+static smart_msgqueue_t *msgtest_rx_queue;
+static uint8_t *msgtest_rx_stacks;          /* 未退出的接收者仍在使用的 scratch 栈 */
+static smart_arena_mark_t msgtest_rx_mark;  /* 回收 msgtest_rx_stacks 时的复位位置 */
+
+static void msgtest_rx_entry(void *param)
+{
+    uint32_t index = (uint32_t)param;
+    smart_msg_t msg;
+    
+    msgtest_rx_type[index] = 0;
+    if (smart_msgqueue_receive_timeout(msgtest_rx_queue, &msg, 100) == SMART_MSGQ_OK)
+    {
+        msgtest_rx_type[index] = msg.type;
+    }
+}
+
+/* 两个接收者任务都已退出（栈不再使用）时返回 1 */
+static int msgtest_rx_all_exited(void)
+{
+    for (uint32_t i = 0; i < MSGTEST_RX_TASKS; i++)
+    {
+        if (msgtest_rx_task[i].state != TASK_STATE_EXIT)
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
 static int cmd_msgtest(int argc, char *argv[])
 {
     (void)argc;
@@ -649,6 +807,7 @@ static int cmd_msgtest(int argc, char *argv[])
     static smart_msgqueue_t test_queue;
     
     smart_msgqueue_init(&test_queue, msg_buffer, 8);
+    smart_msgqueue_register(&test_queue, "msgtest");
     
     smart_uart_print("1. Queue initialized (capacity=8)\n");
     smart_uart_print("   Count: ");
@@ -752,6 +911,294 @@ static int cmd_msgtest(int argc, char *argv[])
     smart_uart_print(smart_msgqueue_is_empty(&test_queue) ? "EMPTY" : "NOT EMPTY");
     smart_uart_print("\n\n");
     
+    /* 测试带超时的阻塞接收 */
+    smart_uart_print("6. Timed receive on empty queue (10ms)...\n");
+    uint32_t wait_start = smart_get_tick();
+    smart_msg_t timed_msg;
+    smart_msgq_status_t timed_status = smart_msgqueue_receive_timeout(&test_queue, &timed_msg, 10);
+    smart_uart_print("   Result: ");
+    smart_uart_print(timed_status == SMART_MSGQ_TIMEOUT ? "TIMEOUT (expected)" : "FAILED");
+    smart_uart_print(" after ");
+    smart_uart_print_hex32(smart_get_tick() - wait_start);
+    smart_uart_print(" ticks\n\n");
+    
+    /* 测试零拷贝多播 */
+    smart_uart_print("7. Zero-copy multicast to 2 queues...\n");
+    smart_mempool_t *pool = smart_mempool_find("telemetry");
+    static smart_msg_t second_buffer[4];
+    static smart_msgqueue_t second_queue;
+    smart_msgqueue_init(&second_queue, second_buffer, 4);
+    smart_msgqueue_register(&second_queue, "msgtest2");
+    
+    uint16_t free_before = smart_mempool_get_free(pool);
+    uint32_t payload_size = 0;
+    char *payload = (char *)smart_msg_alloc(pool, &payload_size);
+    if (payload)
+    {
+        memcpy(payload, "frame", 6);
+        smart_msgqueue_t *targets[2] = { &test_queue, &second_queue };
+        uint32_t delivered = smart_msgqueue_multicast_ref(targets, 2, 0x300, payload, 6);
+        smart_uart_print("   Delivered: ");
+        smart_uart_print_hex32(delivered);
+        smart_uart_print(" (payload capacity ");
+        smart_uart_print_hex32(payload_size);
+        smart_uart_print(" bytes)\n");
+        
+        for (int i = 0; i < 2; i++)
+        {
+            smart_msg_t msg;
+            if (smart_msgqueue_receive(targets[i], &msg) == SMART_MSGQ_OK)
+            {
+                smart_uart_print("   Queue ");
+                smart_uart_print_hex32(i);
+                smart_uart_print(": ");
+                smart_uart_print((const char *)msg.ptr);
+                smart_uart_print(msg.ptr == payload ? " (same block)\n" : " (copied?)\n");
+                smart_msg_release(msg.ptr);
+            }
+        }
+    }
+    else
+    {
+        smart_uart_print("   Pool exhausted, skipped\n");
+    }
+    smart_uart_print("   Pool free blocks: ");
+    smart_uart_print_hex32(free_before);
+    smart_uart_print(" -> ");
+    smart_uart_print_hex32(smart_mempool_get_free(pool));
+    smart_uart_print("\n\n");
+    
+    /* 测试变长消息缓冲区（写满后回绕） */
+    smart_uart_print("8. Variable-length message buffer (64 bytes)...\n");
+    static uint32_t msgbuf_storage[16];
+    static smart_msgbuf_t test_msgbuf;
+    smart_msgbuf_init(&test_msgbuf, msgbuf_storage, sizeof(msgbuf_storage));
+    
+    static const char *records[] = { "hello", "variable length", "smart-os", "wraparound record" };
+    int written = 0;
+    for (int round = 0; round < 2; round++)
+    {
+        for (int i = 0; i < 4; i++)
+        {
+            if (smart_msgbuf_send(&test_msgbuf, records[i], strlen(records[i]) + 1, 0) == SMART_MSGQ_OK)
+            {
+                written++;
+            }
+            
+            /* 每写两条读出一条，使写位置越过缓冲区末尾 */
+            if (i & 1)
+            {
+                char out[32];
+                uint32_t out_len = 0;
+                if (smart_msgbuf_receive(&test_msgbuf, out, sizeof(out), &out_len, 0) == SMART_MSGQ_OK)
+                {
+                    smart_uart_print("   Recv ");
+                    smart_uart_print_hex32(out_len);
+                    smart_uart_print(" bytes: ");
+                    smart_uart_print(out);
+                    smart_uart_print("\n");
+                }
+            }
+        }
+    }
+    
+    /* 原地读取剩余记录 */
+    void *record;
+    uint32_t record_len;
+    while (smart_msgbuf_peek(&test_msgbuf, &record, &record_len, 0) == SMART_MSGQ_OK)
+    {
+        smart_uart_print("   Peek ");
+        smart_uart_print_hex32(record_len);
+        smart_uart_print(" bytes: ");
+        smart_uart_print((const char *)record);
+        smart_uart_print("\n");
+        smart_msgbuf_consume(&test_msgbuf);
+    }
+    smart_uart_print("   Written: ");
+    smart_uart_print_hex32(written);
+    smart_uart_print(", Dropped: ");
+    smart_uart_print_hex32(test_msgbuf.dropped);
+    smart_uart_print(", Free bytes: ");
+    smart_uart_print_hex32(smart_msgbuf_free_bytes(&test_msgbuf));
+    smart_uart_print("\n\n");
+    
+    /* 测试优先级队列：紧急消息越过排队中的批量数据 */
+    smart_uart_print("9. Priority queue (bulk on lane 3, urgent on lane 0)...\n");
+    static smart_msg_t prio_buffer[4 * SMART_MSGQ_PRIO_LANES];
+    static smart_prio_msgqueue_t prio_queue;
+    smart_prio_msgqueue_init(&prio_queue, prio_buffer, 4);
+    smart_prio_msgqueue_register(&prio_queue, "msgprio");
+    
+    for (int i = 0; i < 6; i++)
+    {
+        smart_msg_t msg = { 0x400 + i, i, NULL };
+        smart_prio_msgqueue_send(&prio_queue, &msg, SMART_MSGQ_PRIO_LANES - 1);
+    }
+    smart_msg_t stop_msg = { 0x4FF, 0, NULL };
+    smart_prio_msgqueue_send(&prio_queue, &stop_msg, 0);
+    
+    smart_msg_t first;
+    uint32_t first_lane = 0;
+    smart_prio_msgqueue_receive(&prio_queue, &first, &first_lane, 0);
+    smart_uart_print("   First received: type=");
+    smart_uart_print_hex32(first.type);
+    smart_uart_print(", lane ");
+    smart_uart_print_hex32(first_lane);
+    smart_uart_print(first.type == 0x4FF ? " (urgent first)\n" : " (FAILED)\n");
+    
+    int bulk = 0;
+    while (smart_prio_msgqueue_receive(&prio_queue, &first, NULL, 0) == SMART_MSGQ_OK)
+    {
+        bulk++;
+    }
+    smart_uart_print("   Bulk drained: ");
+    smart_uart_print_hex32(bulk);
+    smart_uart_print("\n");
+    
+    for (uint32_t lane = 0; lane < SMART_MSGQ_PRIO_LANES; lane++)
+    {
+        smart_msgq_lane_stats_t lane_stats;
+        smart_prio_msgqueue_get_stats(&prio_queue, lane, &lane_stats);
+        smart_uart_print("   Lane ");
+        smart_uart_print_hex32(lane);
+        smart_uart_print(": enq=");
+        smart_uart_print_hex32(lane_stats.enqueued);
+        smart_uart_print(" drop=");
+        smart_uart_print_hex32(lane_stats.dropped);
+        smart_uart_print(" max=");
+        smart_uart_print_hex32(lane_stats.max_depth);
+        smart_uart_print("\n");
+    }
+    smart_uart_print("\n");
+    
+    /* 测试主题总线：按类型过滤，共享同一载荷块 */
+    smart_uart_print("10. Topic publish (filtered, shared payload)...\n");
+    static smart_topic_t telemetry_topic;
+    static smart_topic_sub_t all_sub, imu_sub;
+    /* 再次运行 msgtest 时主题已注册（init 返回 INVALID），订阅就地更新 */
+    smart_topic_init(&telemetry_topic, "telemetry");
+    smart_topic_subscribe(&telemetry_topic, &all_sub, &test_queue, 0, 0);
+    smart_topic_subscribe(&telemetry_topic, &imu_sub, &second_queue, 0xFF00, 0x0100);
+    
+    static const uint32_t topic_types[2] = { 0x0101, 0x0201 };
+    for (int i = 0; i < 2; i++)
+    {
+        char *frame = (char *)smart_msg_alloc(pool, NULL);
+        if (!frame)
+        {
+            smart_uart_print("   Pool exhausted, skipped\n");
+            break;
+        }
+        memcpy(frame, "sample", 7);
+        uint32_t delivered = smart_topic_publish_ref(&telemetry_topic, topic_types[i], frame, 7);
+        smart_uart_print("   type=");
+        smart_uart_print_hex32(topic_types[i]);
+        smart_uart_print(" -> ");
+        smart_uart_print_hex32(delivered);
+        smart_uart_print(" subscriber(s)\n");
+    }
+    
+    /* 订阅者处理完释放引用 */
+    smart_msgqueue_t *subscribers[2] = { &test_queue, &second_queue };
+    for (int i = 0; i < 2; i++)
+    {
+        smart_msg_t msg;
+        while (smart_msgqueue_receive(subscribers[i], &msg) == SMART_MSGQ_OK)
+        {
+            smart_msg_release(msg.ptr);
+        }
+    }
+    smart_uart_print("   Pool free blocks: ");
+    smart_uart_print_hex32(smart_mempool_get_free(pool));
+    smart_uart_print(" (see 'topic')\n\n");
+    
+    /* 测试两个阻塞接收者 + 批量发送：接收者接力取走消息，顺序与发送顺序一致 */
+    smart_uart_print("11. Two blocked receivers, batch of 4...\n");
+    /* 上次未退出的接收者仍在使用 scratch 中的栈，退出后才回收 */
+    if (msgtest_rx_stacks && msgtest_rx_all_exited())
+    {
+        smart_arena_reset(&smart_scratch, msgtest_rx_mark);
+        msgtest_rx_stacks = NULL;
+    }
+    
+    if (msgtest_rx_stacks)
+    {
+        smart_uart_print("   Skipped: receivers from last run still alive\n\n");
+    }
+    else
+    {
+        /* 不用 SMART_ARENA_SCOPE：接收者未退出时栈不能随作用域回收 */
+        smart_arena_mark_t mark = smart_arena_mark(&smart_scratch);
+        uint8_t *rx_stacks = (uint8_t *)smart_arena_alloc(&smart_scratch,
+                                                          MSGTEST_RX_TASKS * MSGTEST_RX_STACK_SIZE);
+        if (!rx_stacks)
+        {
+            smart_uart_print("   Error: scratch memory busy\n\n");
+        }
+        else
+        {
+            msgtest_rx_queue = &test_queue;
+            for (uint32_t i = 0; i < MSGTEST_RX_TASKS; i++)
+            {
+                /* 截止时间不同：接收者 0 更紧急，应拿到第一条 */
+                smart_task_create(&msgtest_rx_task[i], msgtest_rx_entry, (void *)i,
+                                  rx_stacks + i * MSGTEST_RX_STACK_SIZE, MSGTEST_RX_STACK_SIZE,
+                                  1000, 10 + i * 10);
+            }
+            
+            /* 让两个接收者先在空队列上阻塞 */
+            smart_delay(2);
+            
+            smart_msg_t batch[4];
+            for (uint32_t i = 0; i < 4; i++)
+            {
+                batch[i].type = 0x500 + i;
+                batch[i].data = i;
+                batch[i].ptr = NULL;
+            }
+            uint32_t sent = smart_msgqueue_send_n(&test_queue, batch, 4);
+            
+            uint32_t waited = 0;
+            while (!msgtest_rx_all_exited() && waited < 200)
+            {
+                smart_delay(1);
+                waited++;
+            }
+            
+            smart_msg_t rest[4];
+            uint32_t remaining = smart_msgqueue_receive_n(&test_queue, rest, 4);
+            
+            int exited = msgtest_rx_all_exited();
+            int order_ok = (exited && sent == 4 && remaining == 2 &&
+                            msgtest_rx_type[0] == 0x500 && msgtest_rx_type[1] == 0x501 &&
+                            rest[0].type == 0x502 && rest[1].type == 0x503);
+            for (uint32_t i = 0; i < MSGTEST_RX_TASKS; i++)
+            {
+                smart_uart_print("   Receiver ");
+                smart_uart_print_hex32(i);
+                smart_uart_print(": type=");
+                smart_uart_print_hex32(msgtest_rx_type[i]);
+                smart_uart_print("\n");
+            }
+            smart_uart_print("   Left in queue: ");
+            smart_uart_print_hex32(remaining);
+            smart_uart_print(order_ok ? " -> FIFO order PASS\n" : " -> FIFO order FAIL\n");
+            
+            if (exited)
+            {
+                smart_arena_reset(&smart_scratch, mark);
+            }
+            else
+            {
+                /* 任务仍在 task_list 中，栈保持占用，下次运行时再回收 */
+                msgtest_rx_stacks = rx_stacks;
+                msgtest_rx_mark = mark;
+                smart_uart_print("   Receivers still alive, stacks kept\n");
+            }
+            smart_uart_print("\n");
+        }
+    }
+    
     smart_uart_print("=== Test Complete ===\n\n");
     
     return 0;
@@ -919,10 +1366,93 @@ static int cmd_synctest(int argc, char *argv[])
     smart_mutex_unlock(&test_mutex);
     smart_uart_print("\n");
     
+    /* 测试事件组 */
+    smart_uart_print("3. Testing Event Group...\n");
+    
+    static smart_event_group_t test_event;
+    smart_event_init(&test_event, 0);
+    uint32_t bits = 0;
+    
+    smart_uart_print("   Setting bits 0x05...\n");
+    smart_event_set(&test_event, 0x05);
+    
+    status = smart_event_wait(&test_event, 0x06, SMART_EVENT_WAIT_ANY, 0, &bits);
+    smart_uart_print("   Wait ANY 0x06: ");
+    smart_uart_print(status == SMART_SYNC_OK ? "SUCCESS" : "FAILED");
+    smart_uart_print(", bits=0x");
+    smart_uart_print_hex32(bits);
+    smart_uart_print("\n");
+    
+    status = smart_event_wait(&test_event, 0x06, SMART_EVENT_WAIT_ALL, 0, &bits);
+    smart_uart_print("   Wait ALL 0x06: ");
+    smart_uart_print(status == SMART_SYNC_TIMEOUT ? "TIMEOUT (expected)" : "FAILED");
+    smart_uart_print("\n");
+    
+    status = smart_event_wait(&test_event, 0x05,
+                              SMART_EVENT_WAIT_ALL | SMART_EVENT_CLEAR_ON_EXIT, 0, &bits);
+    smart_uart_print("   Wait ALL 0x05 + clear: ");
+    smart_uart_print(status == SMART_SYNC_OK ? "SUCCESS" : "FAILED");
+    smart_uart_print(", bits now=0x");
+    smart_uart_print_hex32(smart_event_get(&test_event));
+    smart_uart_print("\n\n");
+    
+    /* 测试读写锁 */
+    smart_uart_print("4. Testing RW Lock...\n");
+    
+    static smart_rwlock_t test_rwlock;
+    smart_rwlock_init(&test_rwlock);
+    
+    smart_rwlock_read_lock(&test_rwlock, 0);
+    status = smart_rwlock_read_lock(&test_rwlock, 0);
+    smart_uart_print("   Two readers: ");
+    smart_uart_print(status == SMART_SYNC_OK ? "SUCCESS" : "FAILED");
+    smart_uart_print(", readers=");
+    smart_uart_print_hex32(test_rwlock.readers);
+    smart_uart_print("\n");
+    
+    status = smart_rwlock_write_lock(&test_rwlock, 0);
+    smart_uart_print("   Writer while read-locked: ");
+    smart_uart_print(status == SMART_SYNC_TIMEOUT ? "TIMEOUT (expected)" : "FAILED");
+    smart_uart_print("\n");
+    
+    smart_rwlock_read_unlock(&test_rwlock);
+    smart_rwlock_read_unlock(&test_rwlock);
+    status = smart_rwlock_write_lock(&test_rwlock, 0);
+    smart_uart_print("   Writer after readers left: ");
+    smart_uart_print(status == SMART_SYNC_OK ? "SUCCESS" : "FAILED");
+    smart_uart_print("\n");
+    smart_rwlock_write_unlock(&test_rwlock);
+    smart_uart_print("\n");
+    
+    /* 测试条件变量 */
+    smart_uart_print("5. Testing Condition Variable...\n");
+    
+    static smart_cond_t test_cond;
+    smart_cond_init(&test_cond);
+    smart_mutex_lock(&test_mutex);
+    smart_mutex_lock(&test_mutex);
+    
+    status = smart_cond_wait_timeout(&test_cond, &test_mutex, 10);
+    smart_uart_print("   Wait 10ms (no signal): ");
+    smart_uart_print(status == SMART_SYNC_TIMEOUT ? "TIMEOUT (expected)" : "FAILED");
+    smart_uart_print("\n");
+    smart_uart_print("   Mutex re-acquired: ");
+    smart_uart_print((test_mutex.owner == smart_get_current_task() && test_mutex.lock_count == 2)
+                     ? "YES (depth 2)" : "NO");
+    smart_uart_print("\n");
+    
+    smart_cond_broadcast(&test_cond);
+    smart_mutex_unlock(&test_mutex);
+    smart_mutex_unlock(&test_mutex);
+    smart_uart_print("\n");
+    
     smart_uart_print("=== Test Complete ===\n");
     smart_uart_print("Features tested:\n");
     smart_uart_print("  * Semaphore: init, wait, post, try_wait\n");
     smart_uart_print("  * Mutex: init, lock, unlock, try_lock, recursive lock\n");
+    smart_uart_print("  * Event group: set, wait any/all, clear on exit\n");
+    smart_uart_print("  * RW lock: shared readers, exclusive writer\n");
+    smart_uart_print("  * Condition variable: timed wait, mutex re-acquire\n");
     smart_uart_print("  * Priority inheritance (implicit)\n\n");
     
     return 0;
@@ -983,6 +1513,181 @@ static int cmd_uartinfo(int argc, char *argv[])
     return 0;
 }
 
+static int cmd_critinfo(int argc, char *argv[])
+{
+    if (argc >= 2 && strcmp(argv[1], "reset") == 0) {
+        smart_reset_critical_stats();
+        smart_uart_print("Critical section stats reset\n");
+        return 0;
+    }
+    
+    smart_critical_stats_t stats;
+    smart_get_critical_stats(&stats);
+    
+    smart_uart_print("\n=== Critical Section Statistics ===\n\n");
+    
+    smart_uart_print("Masking mode:     ");
+    if (stats.ceiling) {
+        smart_uart_print("BASEPRI ceiling 0x");
+        smart_uart_print_hex32(stats.ceiling);
+        smart_uart_print("\n");
+        smart_uart_print("Unmasked IRQs:    priority < 0x");
+        smart_uart_print_hex32(stats.ceiling);
+        smart_uart_print(" (no kernel API allowed)\n");
+    } else {
+        smart_uart_print("CPSID I (all interrupts)\n");
+    }
+    
+    smart_uart_print("Sections entered: ");
+    smart_uart_print_hex32(stats.enter_count);
+    smart_uart_print("\n");
+    
+    smart_uart_print("Longest section:  ");
+    smart_uart_print_hex32(stats.max_cycles);
+    smart_uart_print(" cycles\n");
+    
+    smart_uart_print("Call site:        0x");
+    smart_uart_print_hex32(stats.max_site);
+    smart_uart_print("\n\n");
+    
+    return 0;
+}
+
+static int cmd_topic(int argc, char *argv[])
+{
+    (void)argc;
+    (void)argv;
+    
+    smart_uart_print("\n=== Topics ===\n\n");
+    
+    smart_topic_t *topic = smart_topic_next(NULL);
+    if (!topic) {
+        smart_uart_print("No topics registered\n\n");
+        return 0;
+    }
+    
+    for (; topic; topic = smart_topic_next(topic)) {
+        smart_uart_print(topic->name ? topic->name : "(unnamed)");
+        smart_uart_print(": published ");
+        smart_uart_print_hex32(topic->published);
+        smart_uart_print("\n");
+        
+        for (smart_topic_sub_t *sub = topic->subs; sub; sub = sub->next) {
+            smart_uart_print("  mask=");
+            smart_uart_print_hex32(sub->type_mask);
+            smart_uart_print(" value=");
+            smart_uart_print_hex32(sub->type_value);
+            smart_uart_print(" delivered=");
+            smart_uart_print_hex32(sub->delivered);
+            smart_uart_print(" dropped=");
+            smart_uart_print_hex32(sub->dropped);
+            smart_uart_print("\n");
+        }
+    }
+    smart_uart_print("\n");
+    
+    return 0;
+}
+
+static int cmd_mq(int argc, char *argv[])
+{
+    smart_msgqueue_t *queue;
+    smart_prio_msgqueue_t *prio;
+    
+#if SMART_MSGQ_STATS
+    if (argc >= 2 && strcmp(argv[1], "reset") == 0) {
+        for (queue = smart_msgqueue_next_registered(NULL); queue;
+             queue = smart_msgqueue_next_registered(queue)) {
+            smart_msgqueue_reset_stats(queue);
+        }
+        smart_uart_print("Message queue stats reset\n");
+        return 0;
+    }
+#else
+    (void)argc;
+    (void)argv;
+#endif
+    
+    smart_uart_print("\n=== Message Queues ===\n\n");
+    
+    queue = smart_msgqueue_next_registered(NULL);
+    prio = smart_prio_msgqueue_next_registered(NULL);
+    if (!queue && !prio) {
+        smart_uart_print("No queues registered (run msgtest)\n\n");
+        return 0;
+    }
+    
+    for (; queue; queue = smart_msgqueue_next_registered(queue)) {
+        smart_uart_print(queue->name ? queue->name : "(unnamed)");
+        smart_uart_print(": depth ");
+        smart_uart_print_hex32(smart_msgqueue_count(queue));
+        smart_uart_print("/");
+        smart_uart_print_hex32(queue->capacity);
+        smart_uart_print(", dropped ");
+        smart_uart_print_hex32(queue->dropped);
+        smart_uart_print("\n");
+        
+#if SMART_MSGQ_STATS
+        smart_msgq_stats_t stats;
+        smart_msgqueue_get_stats(queue, &stats);
+        
+        smart_uart_print("  High water: ");
+        smart_uart_print_hex32(stats.high_water);
+        smart_uart_print("\n  Depth hist: ");
+        for (int i = 0; i < SMART_MSGQ_HIST_BINS; i++) {
+            smart_uart_print_hex32(stats.depth_hist[i]);
+            smart_uart_print(" ");
+        }
+        smart_uart_print("(by quarter of capacity)\n");
+        smart_uart_print("  Latency:    avg ");
+        smart_uart_print_hex32(stats.latency_avg);
+        smart_uart_print(", max ");
+        smart_uart_print_hex32(stats.latency_max);
+        smart_uart_print(" cycles (");
+        smart_uart_print_hex32(stats.latency_samples);
+        smart_uart_print(" samples)\n");
+#endif
+    }
+    
+    for (; prio; prio = smart_prio_msgqueue_next_registered(prio)) {
+        smart_uart_print(prio->name ? prio->name : "(unnamed)");
+        smart_uart_print(": priority, depth ");
+        smart_uart_print_hex32(smart_prio_msgqueue_count(prio));
+        smart_uart_print("\n");
+        
+        for (uint32_t lane = 0; lane < SMART_MSGQ_PRIO_LANES; lane++) {
+            smart_msgq_lane_stats_t lane_stats;
+            smart_prio_msgqueue_get_stats(prio, lane, &lane_stats);
+            smart_uart_print("  Lane ");
+            smart_uart_print_hex32(lane);
+            smart_uart_print(": enq=");
+            smart_uart_print_hex32(lane_stats.enqueued);
+            smart_uart_print(" drop=");
+            smart_uart_print_hex32(lane_stats.dropped);
+            smart_uart_print(" max=");
+            smart_uart_print_hex32(lane_stats.max_depth);
+            smart_uart_print("\n");
+        }
+    }
+    smart_uart_print("\n");
+    
+    return 0;
+}
+
+#if SMART_MEMPOOL_DEBUG
+static int cmd_memdbg(int argc, char *argv[])
+{
+    (void)argc;
+    (void)argv;
+    
+    smart_uart_print("\n=== Outstanding Pool Blocks (by task) ===\n\n");
+    smart_mempool_debug_dump();
+    smart_uart_print("\n");
+    
+    return 0;
+}
+#endif
+
 /* ========== 系统测试命令 ========== */
 
 static int cmd_test(int argc, char *argv[])
@@ -1199,13 +1904,15 @@ static int cmd_stress(int argc, char *argv[])
     smart_uart_print("[1] File system stress (10 files)...\n");
     const char *files[] = {"F1.TXT", "F2.TXT", "F3.TXT", "F4.TXT", "F5.TXT",
                            "F6.TXT", "F7.TXT", "F8.TXT", "F9.TXT", "F10.TXT"};
-    char data[64];
-    int fs_pass = 1;
+    SMART_ARENA_SCOPE(&smart_scratch);
+    char *data = (char *)smart_arena_alloc(&smart_scratch, 64);
+    char *read_buf = (char *)smart_arena_alloc(&smart_scratch, 64);
+    int fs_pass = (data && read_buf);
     
     start_time = smart_get_tick();
     
     /* 创建10个文件 */
-    for (int i = 0; i < 10; i++) {
+    for (int i = 0; i < 10 && fs_pass; i++) {
         if (smart_fs_create(files[i]) != SMART_FS_OK) {
             fs_pass = 0;
             break;
@@ -1222,7 +1929,6 @@ static int cmd_stress(int argc, char *argv[])
     }
     
     /* 验证所有文件 */
-    char read_buf[64];
     for (int i = 0; i < 10 && fs_pass; i++) {
         smart_file_t file;
         if (smart_fs_open(files[i], &file) == SMART_FS_OK) {
@@ -1362,15 +2068,95 @@ static int cmd_stress(int argc, char *argv[])
     smart_uart_print("    Result: ");
     smart_uart_print(stability_pass ? "PASS\n" : "FAIL\n");
     
+    /* 测试5: TLSF 堆随机分配/释放 */
+    smart_uart_print("[5] Heap fuzz (2000 random alloc/free)...\n");
+    static void *heap_slots[16];
+    static uint16_t heap_sizes[16];
+    uint32_t seed = smart_get_tick() | 1u;
+    uint32_t heap_fail = 0;
+    uint32_t worst_cycles = 0;
+    int heap_pass = 1;
+    
+    smart_heap_stats_t heap_before;
+    smart_heap_get_stats(&heap_before);
+    
+    for (int i = 0; i < 2000 && heap_pass; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        uint32_t slot = (seed >> 16) & 15u;
+        uint32_t t0 = smart_get_cycles();
+        
+        if (heap_slots[slot]) {
+            /* 释放前校验填充内容，检测越界覆盖 */
+            uint8_t *bytes = (uint8_t *)heap_slots[slot];
+            for (uint32_t j = 0; j < heap_sizes[slot]; j++) {
+                if (bytes[j] != (uint8_t)(slot + j)) {
+                    heap_pass = 0;
+                    break;
+                }
+            }
+            t0 = smart_get_cycles();
+            smart_heap_free(heap_slots[slot]);
+            heap_slots[slot] = NULL;
+        } else {
+            heap_sizes[slot] = (uint16_t)(1u + ((seed >> 8) & 0x1FFu));
+            heap_slots[slot] = smart_heap_alloc(heap_sizes[slot]);
+            if (!heap_slots[slot]) {
+                heap_fail++;
+                continue;
+            }
+            uint32_t cycles = smart_get_cycles() - t0;
+            if (cycles > worst_cycles) worst_cycles = cycles;
+            
+            uint8_t *bytes = (uint8_t *)heap_slots[slot];
+            for (uint32_t j = 0; j < heap_sizes[slot]; j++) {
+                bytes[j] = (uint8_t)(slot + j);
+            }
+            continue;
+        }
+        
+        uint32_t cycles = smart_get_cycles() - t0;
+        if (cycles > worst_cycles) worst_cycles = cycles;
+        
+        if ((i & 63) == 0 && smart_heap_check() != 0) {
+            heap_pass = 0;
+        }
+    }
+    
+    smart_heap_stats_t heap_mid;
+    smart_heap_get_stats(&heap_mid);
+    
+    for (int i = 0; i < 16; i++) {
+        smart_heap_free(heap_slots[i]);
+        heap_slots[i] = NULL;
+    }
+    
+    smart_heap_stats_t heap_after;
+    smart_heap_get_stats(&heap_after);
+    if (smart_heap_check() != 0 || heap_after.free_bytes != heap_before.free_bytes ||
+        heap_after.largest_free != heap_before.largest_free) {
+        heap_pass = 0;
+    }
+    
+    smart_uart_print("    Worst op: ");
+    smart_uart_print_hex32(worst_cycles);
+    smart_uart_print(" cycles\n");
+    smart_uart_print("    Fragmentation: ");
+    smart_uart_print_hex32(heap_mid.fragmentation);
+    smart_uart_print("%, alloc failures: ");
+    smart_uart_print_hex32(heap_fail);
+    smart_uart_print("\n");
+    smart_uart_print("    Result: ");
+    smart_uart_print(heap_pass ? "PASS\n" : "FAIL\n");
+    
     /* 总结 */
-    int total_pass = fs_pass + sem_pass + mutex_pass + stability_pass;
+    int total_pass = fs_pass + sem_pass + mutex_pass + stability_pass + heap_pass;
     smart_uart_print("\n========================================\n");
     smart_uart_print("Stress Test Summary:\n");
     smart_uart_print("  Tests passed: ");
     smart_uart_print_hex32(total_pass);
-    smart_uart_print("/4\n");
+    smart_uart_print("/5\n");
     
-    if (total_pass == 4) {
+    if (total_pass == 5) {
         smart_uart_print("  Status: ALL TESTS PASSED!\n");
         smart_uart_print("\nPerformance Grade: ");
         if (elapsed < 10) {
@@ -1512,6 +2298,18 @@ static int cmd_timer(int argc, char *argv[])
         
         smart_uart_print("   Max callback:    ");
         smart_uart_print_hex32(stats.max_callback_time_us);
+        smart_uart_print(" us\n");
+        
+        smart_uart_print("   Deferred/overrun: ");
+        smart_uart_print_hex32(stats.deferred_count);
+        smart_uart_print(" / ");
+        smart_uart_print_hex32(stats.overrun_count);
+        smart_uart_print("\n");
+        
+        smart_uart_print("   Latency avg/max: ");
+        smart_uart_print_hex32(stats.avg_latency_us);
+        smart_uart_print(" / ");
+        smart_uart_print_hex32(stats.max_latency_us);
         smart_uart_print(" us\n\n");
         
         /* 测试7: 清理定时器 */
@@ -1533,6 +2331,236 @@ static int cmd_timer(int argc, char *argv[])
     return -1;
 }
 
+/* ========== 微基准测试命令 ========== */
+
+#define BENCH_ITERATIONS 1000
+
+/* 旧实现的临界区路径，作为对照 */
+static uint32_t bench_legacy_count;
+
+static int bench_legacy_take(void)
+{
+    int ok = 0;
+    smart_enter_critical();
+    if (bench_legacy_count > 0)
+    {
+        bench_legacy_count--;
+        ok = 1;
+    }
+    smart_exit_critical();
+    return ok;
+}
+
+static void bench_legacy_give(void)
+{
+    smart_enter_critical();
+    bench_legacy_count++;
+    smart_exit_critical();
+}
+
+static void bench_print_result(const char *label, uint32_t cycles,
+                               const smart_critical_stats_t *masked)
+{
+    smart_uart_print(label);
+    smart_uart_print_hex32(cycles / BENCH_ITERATIONS);
+    smart_uart_print(" cycles/pair, critical sections ");
+    smart_uart_print_hex32(masked->enter_count);
+    smart_uart_print(", longest ");
+    smart_uart_print_hex32(masked->max_cycles);
+    smart_uart_print(" cycles\n");
+}
+
+static void bench_sem(void)
+{
+    static smart_semaphore_t sem;
+    uint32_t start, legacy_cycles, lockfree_cycles;
+    smart_critical_stats_t legacy_masked, lockfree_masked;
+    
+    smart_uart_print("\n=== Semaphore take/give (");
+    smart_uart_print_hex32(BENCH_ITERATIONS);
+    smart_uart_print(" pairs, uncontended) ===\n");
+    
+    /* 临界区路径：每次操作在临界区内屏蔽 BASEPRI 以下的中断。
+     * 屏蔽窗口由临界区统计在 smart_enter_critical/smart_exit_critical 内部测得，
+     * 期间发生的其他临界区（如 SysTick）也会计入。
+     */
+    bench_legacy_count = 1;
+    smart_reset_critical_stats();
+    start = smart_get_cycles();
+    for (int i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        bench_legacy_take();
+        bench_legacy_give();
+    }
+    legacy_cycles = smart_get_cycles() - start;
+    smart_get_critical_stats(&legacy_masked);
+    
+    /* 无锁快速路径 */
+    smart_sem_init(&sem, 1, 1);
+    smart_reset_critical_stats();
+    start = smart_get_cycles();
+    for (int i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        smart_sem_try_wait(&sem);
+        smart_sem_post(&sem);
+    }
+    lockfree_cycles = smart_get_cycles() - start;
+    smart_get_critical_stats(&lockfree_masked);
+    
+    bench_print_result("  Critical section: ", legacy_cycles, &legacy_masked);
+    bench_print_result("  LDREX/STREX:      ", lockfree_cycles, &lockfree_masked);
+    
+#if SMART_CRITICAL_STATS
+    smart_uart_print("  Longest IRQ-masked window: ");
+    smart_uart_print_hex32(legacy_masked.max_cycles);
+    smart_uart_print(" -> ");
+    smart_uart_print_hex32(lockfree_masked.max_cycles);
+    smart_uart_print(" cycles (critical stats were reset)\n\n");
+#else
+    smart_uart_print("  IRQ-masked window: n/a (SMART_CRITICAL_STATS=0)\n\n");
+#endif
+}
+
+static void bench_mq(void)
+{
+    static smart_msg_t mq_buffer[16];
+    static smart_msgqueue_t mq;
+    static smart_msg_t spsc_buffer[16];
+    static smart_spsc_msgqueue_t spsc;
+    smart_msg_t msg = { 0x1, 0x2, NULL };
+    smart_msg_t out;
+    smart_msg_t batch[8] = { { 0x1, 0x2, NULL } };
+    smart_msg_t batch_out[8];
+    uint32_t start, mq_cycles, batch_cycles, spsc_cycles;
+    
+    smart_uart_print("\n=== Message queue send+receive (");
+    smart_uart_print_hex32(BENCH_ITERATIONS);
+    smart_uart_print(" msgs, batches of 8) ===\n");
+    
+    smart_msgqueue_init(&mq, mq_buffer, 16);
+    smart_spsc_msgqueue_init(&spsc, spsc_buffer, 16);
+    
+    start = smart_get_cycles();
+    for (int i = 0; i < BENCH_ITERATIONS; i += 8)
+    {
+        for (int j = 0; j < 8; j++) smart_msgqueue_send(&mq, &msg);
+        for (int j = 0; j < 8; j++) smart_msgqueue_receive(&mq, &out);
+    }
+    mq_cycles = smart_get_cycles() - start;
+    
+    start = smart_get_cycles();
+    for (int i = 0; i < BENCH_ITERATIONS; i += 8)
+    {
+        smart_msgqueue_send_n(&mq, batch, 8);
+        smart_msgqueue_receive_n(&mq, batch_out, 8);
+    }
+    batch_cycles = smart_get_cycles() - start;
+    
+    start = smart_get_cycles();
+    for (int i = 0; i < BENCH_ITERATIONS; i += 8)
+    {
+        for (int j = 0; j < 8; j++) smart_spsc_msgqueue_send(&spsc, &msg);
+        for (int j = 0; j < 8; j++) smart_spsc_msgqueue_receive(&spsc, &out);
+    }
+    spsc_cycles = smart_get_cycles() - start;
+    
+    smart_uart_print("  smart_msgqueue (critical, %): ");
+    smart_uart_print_hex32(mq_cycles / BENCH_ITERATIONS);
+    smart_uart_print(" cycles/msg\n");
+    smart_uart_print("  smart_msgqueue send_n/recv_n: ");
+    smart_uart_print_hex32(batch_cycles / BENCH_ITERATIONS);
+    smart_uart_print(" cycles/msg\n");
+    smart_uart_print("  SPSC lock-free (mask):        ");
+    smart_uart_print_hex32(spsc_cycles / BENCH_ITERATIONS);
+    smart_uart_print(" cycles/msg\n");
+    if (spsc_cycles > 0) {
+        smart_uart_print("  Speedup: x");
+        smart_uart_print_hex32(mq_cycles / spsc_cycles);
+        smart_uart_print("\n");
+    }
+    smart_uart_print("\n");
+}
+
+static void bench_pool(void)
+{
+    static uint32_t pool_buffer[SMART_MEMPOOL_BUFFER_SIZE(16, 8) / 4] SMART_SECTION_POOL;
+    static smart_mempool_t pool;
+    uint32_t start, direct_cycles;
+    void *block;
+    
+    smart_uart_print("\n=== Mempool alloc+free (");
+    smart_uart_print_hex32(BENCH_ITERATIONS);
+    smart_uart_print(" pairs) ===\n");
+    
+    if (smart_mempool_init(&pool, pool_buffer, 16, 8, 0) != SMART_MEMPOOL_OK)
+    {
+        smart_uart_print("  Error: bench pool still registered\n\n");
+        return;
+    }
+    smart_mempool_set_name(&pool, "bench");
+    
+    start = smart_get_cycles();
+    for (int i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        smart_mempool_alloc_try(&pool, &block);
+        smart_mempool_free_try(&pool, block);
+    }
+    direct_cycles = smart_get_cycles() - start;
+    
+    smart_uart_print("  Shared pool (lock-free):  ");
+    smart_uart_print_hex32(direct_cycles / BENCH_ITERATIONS);
+    smart_uart_print(" cycles/pair\n");
+
+#if SMART_MEMPOOL_CACHE
+    static smart_mempool_cache_t cache;
+    uint32_t cache_cycles;
+    
+    smart_mempool_cache_attach(&cache, &pool);
+    start = smart_get_cycles();
+    for (int i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        smart_mempool_cache_alloc(&pool, &block);
+        smart_mempool_cache_free(&pool, block);
+    }
+    cache_cycles = smart_get_cycles() - start;
+    smart_mempool_cache_detach(&cache);
+    
+    smart_uart_print("  Per-task cache:           ");
+    smart_uart_print_hex32(cache_cycles / BENCH_ITERATIONS);
+    smart_uart_print(" cycles/pair\n");
+#endif
+    smart_mempool_deinit(&pool);
+    smart_uart_print("\n");
+}
+
+static int cmd_bench(int argc, char *argv[])
+{
+    if (argc < 2) {
+        bench_sem();
+        bench_mq();
+        bench_pool();
+        return 0;
+    }
+    
+    if (strcmp(argv[1], "sem") == 0) {
+        bench_sem();
+        return 0;
+    }
+    
+    if (strcmp(argv[1], "mq") == 0) {
+        bench_mq();
+        return 0;
+    }
+    
+    if (strcmp(argv[1], "pool") == 0) {
+        bench_pool();
+        return 0;
+    }
+    
+    smart_uart_print("Usage: bench [sem|mq|pool]\n");
+    return -1;
+}
+
 /* ========== Shell 核心功能 ========== */
 
 static void shell_print_prompt(void)
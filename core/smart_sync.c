@@ -1,8 +1,12 @@
 #include "smart_sync.h"
 #include "smart_core.h"
+#include "smart_atomic.h"
 #include <string.h>
 
-/* ========== 信号量实现 ========== */
+/* ========== 信号量实现 ==========
+ * 快速路径（无等待者时的获取/释放）只用 LDREX/STREX，不关中断；
+ * 只有需要阻塞或唤醒等待者时才进入临界区。
+ */
 
 void smart_sem_init(smart_semaphore_t *sem, uint32_t initial_count, uint32_t max_count)
 {
@@ -21,81 +25,45 @@ void smart_sem_init(smart_semaphore_t *sem, uint32_t initial_count, uint32_t max
 }
 
 smart_sync_status_t smart_sem_wait(smart_semaphore_t *sem)
+{
+    return smart_sem_wait_timeout(sem, SMART_WAIT_FOREVER);
+}
+
+smart_sync_status_t smart_sem_wait_timeout(smart_semaphore_t *sem, uint32_t timeout_ms)
 {
     if (!sem)
     {
         return SMART_SYNC_ERROR;
     }
     
-    smart_enter_critical();
-    
-    /* 如果有可用信号量，直接获取 */
-    if (sem->count > 0)
+    /* 快速路径 */
+    if (smart_atomic_dec_if_positive(&sem->count))
     {
-        sem->count--;
-        smart_exit_critical();
         return SMART_SYNC_OK;
     }
     
-    /* 否则，将当前任务加入等待队列 */
     smart_task_t current = smart_get_current_task();
-    if (current)
+    if (!current || timeout_ms == 0)
     {
-        current->state = TASK_STATE_WAITING;
-        
-        /* 添加到等待队列 */
-        if (sem->wait_list == NULL)
-        {
-            sem->wait_list = current;
-            current->next = NULL;
-        }
-        else
-        {
-            /* 插入到队列末尾 */
-            smart_task_t node = sem->wait_list;
-            while (node->next != NULL)
-            {
-                node = node->next;
-            }
-            node->next = current;
-            current->next = NULL;
-        }
+        return SMART_SYNC_TIMEOUT;
     }
     
-    smart_exit_critical();
-    
-    /* 触发调度，切换到其他任务 */
-    smart_task_yield();
+    smart_enter_critical();
     
-    return SMART_SYNC_OK;
-}
-
-smart_sync_status_t smart_sem_wait_timeout(smart_semaphore_t *sem, uint32_t timeout_ms)
-{
-    if (!sem)
+    /* 关中断后再检查一次，避免错过检查之后的释放 */
+    if (sem->count > 0)
     {
-        return SMART_SYNC_ERROR;
+        sem->count--;
+        smart_exit_critical();
+        return SMART_SYNC_OK;
     }
     
-    uint32_t start_time = smart_get_tick();
+    /* 阻塞等待，释放方直接移交，计数不经过 count */
+    uint8_t result = smart_task_block(&sem->wait_list, timeout_ms);
     
-    while (1)
-    {
-        /* 尝试获取信号量 */
-        if (smart_sem_try_wait(sem) == SMART_SYNC_OK)
-        {
-            return SMART_SYNC_OK;
-        }
-        
-        /* 检查超时 */
-        if ((smart_get_tick() - start_time) >= timeout_ms)
-        {
-            return SMART_SYNC_TIMEOUT;
-        }
-        
-        /* 让出CPU */
-        smart_task_yield();
-    }
+    smart_exit_critical();
+    
+    return (result == SMART_WAIT_OK) ? SMART_SYNC_OK : SMART_SYNC_TIMEOUT;
 }
 
 smart_sync_status_t smart_sem_try_wait(smart_semaphore_t *sem)
@@ -105,17 +73,7 @@ smart_sync_status_t smart_sem_try_wait(smart_semaphore_t *sem)
         return SMART_SYNC_ERROR;
     }
     
-    smart_enter_critical();
-    
-    if (sem->count > 0)
-    {
-        sem->count--;
-        smart_exit_critical();
-        return SMART_SYNC_OK;
-    }
-    
-    smart_exit_critical();
-    return SMART_SYNC_TIMEOUT;
+    return smart_atomic_dec_if_positive(&sem->count) ? SMART_SYNC_OK : SMART_SYNC_TIMEOUT;
 }
 
 smart_sync_status_t smart_sem_post(smart_semaphore_t *sem)
@@ -125,26 +83,39 @@ smart_sync_status_t smart_sem_post(smart_semaphore_t *sem)
         return SMART_SYNC_ERROR;
     }
     
+    /* 快速路径：无等待者时原子加一。等待者只在关中断时入队，
+     * 若入队发生在 LDREX 之后，异常返回会清除独占监视器使 STREX 失败重试
+     */
+    uint32_t value;
+    do {
+        value = smart_ldrex(&sem->count);
+        if (sem->wait_list != NULL)
+        {
+            smart_clrex();
+            break;
+        }
+        if (value >= sem->max_count)
+        {
+            smart_clrex();
+            return SMART_SYNC_OK;
+        }
+        if (smart_strex(value + 1u, &sem->count) == 0)
+        {
+            return SMART_SYNC_OK;
+        }
+    } while (1);
+    
     smart_enter_critical();
     
-    /* 如果有等待的任务，唤醒第一个 */
+    /* 如果有等待的任务，唤醒deadline最小的一个 */
     if (sem->wait_list != NULL)
     {
-        smart_task_t task = sem->wait_list;
-        sem->wait_list = task->next;
-        task->next = NULL;
-        task->state = TASK_STATE_READY;
-        
-        smart_exit_critical();
+        smart_task_wakeup(sem->wait_list, SMART_WAIT_OK);
         
         /* 触发调度 */
         smart_schedule();
-        
-        return SMART_SYNC_OK;
     }
-    
-    /* 否则，增加计数 */
-    if (sem->count < sem->max_count)
+    else if (sem->count < sem->max_count)
     {
         sem->count++;
     }
@@ -166,6 +137,49 @@ uint32_t smart_sem_get_count(smart_semaphore_t *sem)
 
 /* ========== 互斥锁实现 ========== */
 
+/* 优先级继承：持有者的 deadline 取原始值与最紧急等待者中的较小者 */
+static void smart_mutex_update_inheritance(smart_mutex_t *mutex)
+{
+    smart_task_t owner = mutex->owner;
+    if (!owner)
+    {
+        return;
+    }
+    
+    owner->deadline = mutex->original_deadline;
+    if (mutex->wait_list != NULL && mutex->wait_list->deadline < owner->deadline)
+    {
+        owner->deadline = mutex->wait_list->deadline;
+    }
+}
+
+/* 彻底释放锁并移交给最紧急的等待者（需在临界区内调用），返回是否唤醒了任务 */
+static int smart_mutex_handoff(smart_mutex_t *mutex)
+{
+    /* 恢复原始优先级 */
+    mutex->owner->deadline = mutex->original_deadline;
+    
+    /* 等待队列按deadline排序，队首即优先级最高者 */
+    smart_task_t best = mutex->wait_list;
+    if (best == NULL)
+    {
+        mutex->locked = 0;
+        mutex->owner = NULL;
+        mutex->lock_count = 0;
+        return 0;
+    }
+    
+    smart_task_wakeup(best, SMART_WAIT_OK);
+    
+    /* 新的持有者，并继承剩余等待者的优先级 */
+    mutex->owner = best;
+    mutex->lock_count = 1;
+    mutex->original_deadline = best->deadline;
+    smart_mutex_update_inheritance(mutex);
+    
+    return 1;
+}
+
 void smart_mutex_init(smart_mutex_t *mutex)
 {
     if (!mutex)
@@ -185,6 +199,11 @@ void smart_mutex_init(smart_mutex_t *mutex)
 }
 
 smart_sync_status_t smart_mutex_lock(smart_mutex_t *mutex)
+{
+    return smart_mutex_lock_timeout(mutex, SMART_WAIT_FOREVER);
+}
+
+smart_sync_status_t smart_mutex_lock_timeout(smart_mutex_t *mutex, uint32_t timeout_ms)
 {
     if (!mutex)
     {
@@ -219,70 +238,390 @@ smart_sync_status_t smart_mutex_lock(smart_mutex_t *mutex)
         return SMART_SYNC_OK;
     }
     
+    if (timeout_ms == 0)
+    {
+        smart_exit_critical();
+        return SMART_SYNC_TIMEOUT;
+    }
+    
     /* 优先级继承：如果当前任务优先级更高，提升锁持有者的优先级 */
     if (current->deadline < mutex->owner->deadline)
     {
         mutex->owner->deadline = current->deadline;
     }
     
-    /* 将当前任务加入等待队列 */
-    current->state = TASK_STATE_WAITING;
+    /* 阻塞等待，解锁方直接移交所有权 */
+    uint8_t result = smart_task_block(&mutex->wait_list, timeout_ms);
+    
+    if (result != SMART_WAIT_OK)
+    {
+        /* 超时退出后撤销本任务带来的优先级提升 */
+        smart_mutex_update_inheritance(mutex);
+    }
+    
+    smart_exit_critical();
     
-    if (mutex->wait_list == NULL)
+    return (result == SMART_WAIT_OK) ? SMART_SYNC_OK : SMART_SYNC_TIMEOUT;
+}
+
+smart_sync_status_t smart_mutex_try_lock(smart_mutex_t *mutex)
+{
+    return smart_mutex_lock_timeout(mutex, 0);
+}
+
+smart_sync_status_t smart_mutex_unlock(smart_mutex_t *mutex)
+{
+    if (!mutex)
     {
-        mutex->wait_list = current;
-        current->next = NULL;
+        return SMART_SYNC_ERROR;
     }
-    else
+    
+    smart_task_t current = smart_get_current_task();
+    if (!current)
     {
-        smart_task_t node = mutex->wait_list;
-        while (node->next != NULL)
+        return SMART_SYNC_ERROR;
+    }
+    
+    smart_enter_critical();
+    
+    /* 检查是否是锁的持有者 */
+    if (mutex->owner != current)
+    {
+        smart_exit_critical();
+        return SMART_SYNC_ERROR;
+    }
+    
+    /* 递归锁计数减1 */
+    mutex->lock_count--;
+    
+    /* 如果还有递归锁，不释放 */
+    if (mutex->lock_count > 0)
+    {
+        smart_exit_critical();
+        return SMART_SYNC_OK;
+    }
+    
+    if (smart_mutex_handoff(mutex))
+    {
+        /* 触发调度 */
+        smart_schedule();
+    }
+    
+    smart_exit_critical();
+    
+    return SMART_SYNC_OK;
+}
+
+int smart_mutex_is_locked(smart_mutex_t *mutex)
+{
+    if (!mutex)
+    {
+        return 0;
+    }
+    
+    return mutex->locked;
+}
+
+/* ========== 事件组实现 ========== */
+
+static int smart_event_match(uint32_t current, uint32_t bits, uint8_t options)
+{
+    if (options & SMART_EVENT_WAIT_ALL)
+    {
+        return (current & bits) == bits;
+    }
+    return (current & bits) != 0;
+}
+
+void smart_event_init(smart_event_group_t *event, uint32_t initial_bits)
+{
+    if (!event)
+    {
+        return;
+    }
+    
+    smart_enter_critical();
+    
+    event->bits = initial_bits;
+    event->wait_list = NULL;
+    
+    smart_exit_critical();
+}
+
+smart_sync_status_t smart_event_wait(smart_event_group_t *event, uint32_t bits,
+                                     uint8_t options, uint32_t timeout_ms,
+                                     uint32_t *out_bits)
+{
+    if (!event || bits == 0)
+    {
+        return SMART_SYNC_ERROR;
+    }
+    
+    smart_enter_critical();
+    
+    /* 条件已满足，直接返回 */
+    if (smart_event_match(event->bits, bits, options))
+    {
+        if (out_bits)
+        {
+            *out_bits = event->bits;
+        }
+        if (options & SMART_EVENT_CLEAR_ON_EXIT)
+        {
+            event->bits &= ~bits;
+        }
+        smart_exit_critical();
+        return SMART_SYNC_OK;
+    }
+    
+    smart_task_t current = smart_get_current_task();
+    if (!current || timeout_ms == 0)
+    {
+        if (out_bits)
         {
-            node = node->next;
+            *out_bits = event->bits;
         }
-        node->next = current;
-        current->next = NULL;
+        smart_exit_critical();
+        return SMART_SYNC_TIMEOUT;
+    }
+    
+    /* 阻塞等待，置位方在唤醒时完成匹配与清除 */
+    current->wait_value = bits;
+    current->wait_flags = options;
+    
+    uint8_t result = smart_task_block(&event->wait_list, timeout_ms);
+    
+    if (out_bits)
+    {
+        /* 唤醒时 wait_value 被替换为满足条件时的事件位 */
+        *out_bits = (result == SMART_WAIT_OK) ? current->wait_value : event->bits;
     }
     
     smart_exit_critical();
     
-    /* 触发调度 */
-    smart_task_yield();
+    return (result == SMART_WAIT_OK) ? SMART_SYNC_OK : SMART_SYNC_TIMEOUT;
+}
+
+smart_sync_status_t smart_event_set(smart_event_group_t *event, uint32_t bits)
+{
+    if (!event)
+    {
+        return SMART_SYNC_ERROR;
+    }
+    
+    smart_enter_critical();
+    
+    event->bits |= bits;
+    
+    /* 所有等待者都以本次置位后的值判断，清除动作在遍历结束后统一执行 */
+    uint32_t snapshot = event->bits;
+    uint32_t clear_mask = 0;
+    int woken = 0;
+    smart_task_t *link = &event->wait_list;
+    
+    while (*link != NULL)
+    {
+        smart_task_t node = *link;
+        
+        if (smart_event_match(snapshot, node->wait_value, node->wait_flags))
+        {
+            if (node->wait_flags & SMART_EVENT_CLEAR_ON_EXIT)
+            {
+                clear_mask |= node->wait_value;
+            }
+            
+            /* 原地摘链，避免唤醒时重复遍历 */
+            *link = node->wait_next;
+            node->wait_next = NULL;
+            node->wait_queue = NULL;
+            node->wait_value = snapshot;
+            smart_task_wakeup(node, SMART_WAIT_OK);
+            woken = 1;
+        }
+        else
+        {
+            link = &node->wait_next;
+        }
+    }
+    
+    event->bits &= ~clear_mask;
+    
+    if (woken)
+    {
+        smart_schedule();
+    }
+    
+    smart_exit_critical();
     
     return SMART_SYNC_OK;
 }
 
-smart_sync_status_t smart_mutex_lock_timeout(smart_mutex_t *mutex, uint32_t timeout_ms)
+smart_sync_status_t smart_event_clear(smart_event_group_t *event, uint32_t bits)
 {
-    if (!mutex)
+    if (!event)
     {
         return SMART_SYNC_ERROR;
     }
     
-    uint32_t start_time = smart_get_tick();
+    smart_enter_critical();
+    event->bits &= ~bits;
+    smart_exit_critical();
+    
+    return SMART_SYNC_OK;
+}
+
+uint32_t smart_event_get(smart_event_group_t *event)
+{
+    if (!event)
+    {
+        return 0;
+    }
+    
+    return event->bits;
+}
+
+/* ========== 读写锁实现 ========== */
+
+#define RWLOCK_WAIT_READ   0x00
+#define RWLOCK_WAIT_WRITE  0x01
+
+/* 锁状态变化后移交所有权（需在临界区内调用）
+ * 有写者等待时只交给最紧急的写者，否则一次唤醒全部读者
+ */
+static int smart_rwlock_dispatch(smart_rwlock_t *rwlock)
+{
+    int woken = 0;
+    
+    if (rwlock->writer != NULL)
+    {
+        return 0;
+    }
     
-    while (1)
+    if (rwlock->writers_waiting > 0)
     {
-        /* 尝试获取锁 */
-        if (smart_mutex_try_lock(mutex) == SMART_SYNC_OK)
+        if (rwlock->readers > 0)
         {
-            return SMART_SYNC_OK;
+            return 0;
         }
         
-        /* 检查超时 */
-        if ((smart_get_tick() - start_time) >= timeout_ms)
+        smart_task_t node = rwlock->wait_list;
+        while (node != NULL && node->wait_flags != RWLOCK_WAIT_WRITE)
         {
-            return SMART_SYNC_TIMEOUT;
+            node = node->wait_next;
+        }
+        if (node != NULL)
+        {
+            rwlock->writer = node;
+            rwlock->writers_waiting--;
+            smart_task_wakeup(node, SMART_WAIT_OK);
+            woken = 1;
+        }
+        return woken;
+    }
+    
+    smart_task_t *link = &rwlock->wait_list;
+    while (*link != NULL)
+    {
+        smart_task_t node = *link;
+        if (node->wait_flags == RWLOCK_WAIT_READ)
+        {
+            *link = node->wait_next;
+            node->wait_next = NULL;
+            node->wait_queue = NULL;
+            rwlock->readers++;
+            smart_task_wakeup(node, SMART_WAIT_OK);
+            woken = 1;
+        }
+        else
+        {
+            link = &node->wait_next;
         }
-        
-        /* 让出CPU */
-        smart_task_yield();
     }
+    
+    return woken;
 }
 
-smart_sync_status_t smart_mutex_try_lock(smart_mutex_t *mutex)
+void smart_rwlock_init(smart_rwlock_t *rwlock)
 {
-    if (!mutex)
+    if (!rwlock)
+    {
+        return;
+    }
+    
+    smart_enter_critical();
+    
+    rwlock->readers = 0;
+    rwlock->writer = NULL;
+    rwlock->writers_waiting = 0;
+    rwlock->wait_list = NULL;
+    
+    smart_exit_critical();
+}
+
+smart_sync_status_t smart_rwlock_read_lock(smart_rwlock_t *rwlock, uint32_t timeout_ms)
+{
+    if (!rwlock)
+    {
+        return SMART_SYNC_ERROR;
+    }
+    
+    smart_enter_critical();
+    
+    /* 写者优先：有写者等待时新读者也要排队 */
+    if (rwlock->writer == NULL && rwlock->writers_waiting == 0)
+    {
+        rwlock->readers++;
+        smart_exit_critical();
+        return SMART_SYNC_OK;
+    }
+    
+    smart_task_t current = smart_get_current_task();
+    if (!current || timeout_ms == 0 || rwlock->writer == current)
+    {
+        smart_exit_critical();
+        return SMART_SYNC_TIMEOUT;
+    }
+    
+    current->wait_flags = RWLOCK_WAIT_READ;
+    
+    /* 被唤醒时释放方已完成 readers 计数 */
+    uint8_t result = smart_task_block(&rwlock->wait_list, timeout_ms);
+    
+    smart_exit_critical();
+    
+    return (result == SMART_WAIT_OK) ? SMART_SYNC_OK : SMART_SYNC_TIMEOUT;
+}
+
+smart_sync_status_t smart_rwlock_read_unlock(smart_rwlock_t *rwlock)
+{
+    if (!rwlock)
+    {
+        return SMART_SYNC_ERROR;
+    }
+    
+    smart_enter_critical();
+    
+    if (rwlock->readers == 0)
+    {
+        smart_exit_critical();
+        return SMART_SYNC_ERROR;
+    }
+    
+    rwlock->readers--;
+    
+    if (rwlock->readers == 0 && smart_rwlock_dispatch(rwlock))
+    {
+        smart_schedule();
+    }
+    
+    smart_exit_critical();
+    
+    return SMART_SYNC_OK;
+}
+
+smart_sync_status_t smart_rwlock_write_lock(smart_rwlock_t *rwlock, uint32_t timeout_ms)
+{
+    if (!rwlock)
     {
         return SMART_SYNC_ERROR;
     }
@@ -295,33 +634,118 @@ smart_sync_status_t smart_mutex_try_lock(smart_mutex_t *mutex)
     
     smart_enter_critical();
     
-    /* 如果锁未被占用，直接获取 */
-    if (!mutex->locked)
+    if (rwlock->writer == NULL && rwlock->readers == 0)
     {
-        mutex->locked = 1;
-        mutex->owner = current;
-        mutex->lock_count = 1;
-        mutex->original_deadline = current->deadline;
-        
+        rwlock->writer = current;
         smart_exit_critical();
         return SMART_SYNC_OK;
     }
     
-    /* 如果是同一个任务（递归锁） */
-    if (mutex->owner == current)
+    if (timeout_ms == 0 || rwlock->writer == current)
     {
-        mutex->lock_count++;
         smart_exit_critical();
-        return SMART_SYNC_OK;
+        return SMART_SYNC_TIMEOUT;
+    }
+    
+    current->wait_flags = RWLOCK_WAIT_WRITE;
+    rwlock->writers_waiting++;
+    
+    uint8_t result = smart_task_block(&rwlock->wait_list, timeout_ms);
+    
+    if (result != SMART_WAIT_OK)
+    {
+        /* 超时放弃：可能是最后一个等待的写者，需放行被挡住的读者 */
+        rwlock->writers_waiting--;
+        if (smart_rwlock_dispatch(rwlock))
+        {
+            smart_schedule();
+        }
     }
     
     smart_exit_critical();
-    return SMART_SYNC_TIMEOUT;
+    
+    return (result == SMART_WAIT_OK) ? SMART_SYNC_OK : SMART_SYNC_TIMEOUT;
 }
 
-smart_sync_status_t smart_mutex_unlock(smart_mutex_t *mutex)
+smart_sync_status_t smart_rwlock_write_unlock(smart_rwlock_t *rwlock)
 {
-    if (!mutex)
+    if (!rwlock)
+    {
+        return SMART_SYNC_ERROR;
+    }
+    
+    smart_enter_critical();
+    
+    if (rwlock->writer != smart_get_current_task())
+    {
+        smart_exit_critical();
+        return SMART_SYNC_ERROR;
+    }
+    
+    rwlock->writer = NULL;
+    
+    if (smart_rwlock_dispatch(rwlock))
+    {
+        smart_schedule();
+    }
+    
+    smart_exit_critical();
+    
+    return SMART_SYNC_OK;
+}
+
+/* ========== 条件变量实现 ========== */
+
+/* 将一个已摘出条件变量队列的等待者交给其互斥锁（需在临界区内调用）
+ * 锁空闲则直接授予并唤醒；否则转入互斥锁等待队列，由解锁方移交，
+ * 避免唤醒后再次竞争
+ */
+static int smart_cond_transfer(smart_task_t task)
+{
+    smart_mutex_t *mutex = (smart_mutex_t *)task->wait_obj;
+    
+    if (!mutex->locked)
+    {
+        mutex->locked = 1;
+        mutex->owner = task;
+        mutex->lock_count = 1;
+        mutex->original_deadline = task->deadline;
+        smart_task_wakeup(task, SMART_WAIT_OK);
+        return 1;
+    }
+    
+    task->wait_timeout = SMART_WAIT_FOREVER;
+    smart_wait_queue_insert(&mutex->wait_list, task);
+    
+    if (task->deadline < mutex->owner->deadline)
+    {
+        mutex->owner->deadline = task->deadline;
+    }
+    
+    return 0;
+}
+
+void smart_cond_init(smart_cond_t *cond)
+{
+    if (!cond)
+    {
+        return;
+    }
+    
+    smart_enter_critical();
+    cond->wait_list = NULL;
+    smart_exit_critical();
+}
+
+smart_sync_status_t smart_cond_wait(smart_cond_t *cond, smart_mutex_t *mutex)
+{
+    return smart_cond_wait_timeout(cond, mutex, SMART_WAIT_FOREVER);
+}
+
+smart_sync_status_t smart_cond_wait_timeout(smart_cond_t *cond, smart_mutex_t *mutex,
+                                            uint32_t timeout_ms)
+{
+    if (!cond || !mutex)
     {
         return SMART_SYNC_ERROR;
     }
@@ -334,87 +758,88 @@ smart_sync_status_t smart_mutex_unlock(smart_mutex_t *mutex)
     
     smart_enter_critical();
     
-    /* 检查是否是锁的持有者 */
     if (mutex->owner != current)
     {
         smart_exit_critical();
         return SMART_SYNC_ERROR;
     }
     
-    /* 递归锁计数减1 */
-    mutex->lock_count--;
+    /* 原子地释放互斥锁（含递归层数）并阻塞 */
+    uint32_t saved_count = mutex->lock_count;
+    smart_mutex_handoff(mutex);
     
-    /* 如果还有递归锁，不释放 */
-    if (mutex->lock_count > 0)
+    current->wait_obj = mutex;
+    uint8_t result = smart_task_block(&cond->wait_list, timeout_ms);
+    current->wait_obj = NULL;
+    
+    if (result == SMART_WAIT_OK)
     {
+        /* 唤醒方已将互斥锁移交给本任务 */
+        mutex->lock_count = saved_count;
         smart_exit_critical();
         return SMART_SYNC_OK;
     }
     
-    /* 恢复原始优先级 */
-    current->deadline = mutex->original_deadline;
+    smart_exit_critical();
+    
+    /* 超时：按正常路径重新获取互斥锁（带优先级继承） */
+    smart_mutex_lock(mutex);
+    
+    smart_enter_critical();
+    mutex->lock_count = saved_count;
+    smart_exit_critical();
     
-    /* 如果有等待的任务，唤醒优先级最高的 */
-    if (mutex->wait_list != NULL)
+    return SMART_SYNC_TIMEOUT;
+}
+
+smart_sync_status_t smart_cond_signal(smart_cond_t *cond)
+{
+    if (!cond)
     {
-        /* 找到deadline最小的任务 */
-        smart_task_t best = mutex->wait_list;
-        smart_task_t prev_best = NULL;
-        smart_task_t prev = NULL;
-        smart_task_t node = mutex->wait_list;
-        
-        while (node != NULL)
-        {
-            if (node->deadline < best->deadline)
-            {
-                prev_best = prev;
-                best = node;
-            }
-            prev = node;
-            node = node->next;
-        }
-        
-        /* 从等待队列移除 */
-        if (prev_best == NULL)
-        {
-            mutex->wait_list = best->next;
-        }
-        else
+        return SMART_SYNC_ERROR;
+    }
+    
+    smart_enter_critical();
+    
+    smart_task_t task = cond->wait_list;
+    if (task != NULL)
+    {
+        smart_wait_queue_remove(task);
+        if (smart_cond_transfer(task))
         {
-            prev_best->next = best->next;
+            smart_schedule();
         }
-        
-        best->next = NULL;
-        best->state = TASK_STATE_READY;
-        
-        /* 新的持有者 */
-        mutex->owner = best;
-        mutex->lock_count = 1;
-        mutex->original_deadline = best->deadline;
-        
-        smart_exit_critical();
-        
-        /* 触发调度 */
-        smart_schedule();
-        
-        return SMART_SYNC_OK;
     }
     
-    /* 释放锁 */
-    mutex->locked = 0;
-    mutex->owner = NULL;
-    
     smart_exit_critical();
     
     return SMART_SYNC_OK;
 }
 
-int smart_mutex_is_locked(smart_mutex_t *mutex)
+smart_sync_status_t smart_cond_broadcast(smart_cond_t *cond)
 {
-    if (!mutex)
+    if (!cond)
     {
-        return 0;
+        return SMART_SYNC_ERROR;
     }
     
-    return mutex->locked;
+    smart_enter_critical();
+    
+    /* 一次临界区内转移全部等待者 */
+    int woken = 0;
+    while (cond->wait_list != NULL)
+    {
+        smart_task_t task = cond->wait_list;
+        smart_wait_queue_remove(task);
+        woken |= smart_cond_transfer(task);
+    }
+    
+    if (woken)
+    {
+        smart_schedule();
+    }
+    
+    smart_exit_critical();
+    
+    return SMART_SYNC_OK;
 }
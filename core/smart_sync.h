@@ -14,7 +14,7 @@ typedef enum {
 /* ========== 信号量 ========== */
 
 typedef struct {
-    uint32_t count;           /* 当前计数值 */
+    volatile uint32_t count;  /* 当前计数值（快速路径用 LDREX/STREX 修改） */
     uint32_t max_count;       /* 最大计数值 */
     smart_task_t wait_list;   /* 等待队列 */
 } smart_semaphore_t;
@@ -28,10 +28,10 @@ smart_sync_status_t smart_sem_wait(smart_semaphore_t *sem);
 /* 获取信号量（超时） */
 smart_sync_status_t smart_sem_wait_timeout(smart_semaphore_t *sem, uint32_t timeout_ms);
 
-/* 获取信号量（非阻塞） */
+/* 获取信号量（非阻塞，无锁，可在中断中调用） */
 smart_sync_status_t smart_sem_try_wait(smart_semaphore_t *sem);
 
-/* 释放信号量 */
+/* 释放信号量（无等待者时无锁，可在中断中调用） */
 smart_sync_status_t smart_sem_post(smart_semaphore_t *sem);
 
 /* 获取信号量计数 */
@@ -65,4 +65,83 @@ smart_sync_status_t smart_mutex_unlock(smart_mutex_t *mutex);
 /* 检查是否持有锁 */
 int smart_mutex_is_locked(smart_mutex_t *mutex);
 
+/* ========== 事件组 ========== */
+
+/* 等待选项 */
+#define SMART_EVENT_WAIT_ANY       0x00  /* 任一位置位即满足 */
+#define SMART_EVENT_WAIT_ALL       0x01  /* 所有位置位才满足 */
+#define SMART_EVENT_CLEAR_ON_EXIT  0x02  /* 满足后清除等待的位 */
+
+typedef struct {
+    volatile uint32_t bits;   /* 当前事件位 */
+    smart_task_t wait_list;   /* 等待队列（按deadline排序） */
+} smart_event_group_t;
+
+/* 初始化事件组 */
+void smart_event_init(smart_event_group_t *event, uint32_t initial_bits);
+
+/* 等待事件位（timeout_ms=0 非阻塞，SMART_WAIT_FOREVER 永久等待）
+ * out_bits 返回满足条件时（清除前）的事件位，可为 NULL
+ */
+smart_sync_status_t smart_event_wait(smart_event_group_t *event, uint32_t bits,
+                                     uint8_t options, uint32_t timeout_ms,
+                                     uint32_t *out_bits);
+
+/* 置位事件（可在中断中调用），一次遍历唤醒所有满足条件的任务 */
+smart_sync_status_t smart_event_set(smart_event_group_t *event, uint32_t bits);
+
+/* 清除事件位 */
+smart_sync_status_t smart_event_clear(smart_event_group_t *event, uint32_t bits);
+
+/* 获取当前事件位 */
+uint32_t smart_event_get(smart_event_group_t *event);
+
+/* ========== 读写锁 ========== */
+
+typedef struct {
+    uint32_t readers;          /* 当前持有读锁的任务数 */
+    smart_task_t writer;       /* 持有写锁的任务 */
+    uint32_t writers_waiting;  /* 等待中的写者数（写者优先） */
+    smart_task_t wait_list;    /* 读者与写者共用等待队列（按deadline排序） */
+} smart_rwlock_t;
+
+/* 初始化读写锁 */
+void smart_rwlock_init(smart_rwlock_t *rwlock);
+
+/* 获取读锁：有写者持有或等待时阻塞（timeout_ms=0 非阻塞） */
+smart_sync_status_t smart_rwlock_read_lock(smart_rwlock_t *rwlock, uint32_t timeout_ms);
+
+/* 释放读锁 */
+smart_sync_status_t smart_rwlock_read_unlock(smart_rwlock_t *rwlock);
+
+/* 获取写锁（timeout_ms=0 非阻塞） */
+smart_sync_status_t smart_rwlock_write_lock(smart_rwlock_t *rwlock, uint32_t timeout_ms);
+
+/* 释放写锁 */
+smart_sync_status_t smart_rwlock_write_unlock(smart_rwlock_t *rwlock);
+
+/* ========== 条件变量 ========== */
+
+typedef struct {
+    smart_task_t wait_list;   /* 等待队列（按deadline排序） */
+} smart_cond_t;
+
+/* 初始化条件变量 */
+void smart_cond_init(smart_cond_t *cond);
+
+/* 原子地释放 mutex 并等待，返回前重新持有 mutex（含原递归层数）
+ * 调用者必须持有 mutex
+ */
+smart_sync_status_t smart_cond_wait(smart_cond_t *cond, smart_mutex_t *mutex);
+
+/* 带超时的等待；超时返回 SMART_SYNC_TIMEOUT，此时同样已重新持有 mutex */
+smart_sync_status_t smart_cond_wait_timeout(smart_cond_t *cond, smart_mutex_t *mutex,
+                                            uint32_t timeout_ms);
+
+/* 唤醒最紧急的一个等待者 */
+smart_sync_status_t smart_cond_signal(smart_cond_t *cond);
+
+/* 唤醒全部等待者 */
+smart_sync_status_t smart_cond_broadcast(smart_cond_t *cond);
+
 #endif
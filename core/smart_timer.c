@@ -1,17 +1,39 @@
 #include "smart_timer.h"
 #include "smart_core.h"
 #include "smart_uart.h"
+#include "smart_atomic.h"
+#include "smart_memmap.h"
 #include <string.h>
 
 /* 最大定时器数量 */
 #define MAX_TIMERS 16
 
+/* 时间轮参数 */
+#define WHEEL_SLOTS         (1u << SMART_TIMER_WHEEL_BITS)
+#define WHEEL_MASK          (WHEEL_SLOTS - 1u)
+#define WHEEL_SHIFT(level)  (SMART_TIMER_WHEEL_BITS * (level))
+#define WHEEL_RANGE         (1u << WHEEL_SHIFT(SMART_TIMER_WHEEL_LEVELS))
+
+#if SMART_TIMER_WHEEL_BITS * SMART_TIMER_WHEEL_LEVELS > 30
+#error "timer wheel range must stay below 2^31 ticks"
+#endif
+
+#if (SMART_TIMER_QUEUE_SIZE & (SMART_TIMER_QUEUE_SIZE - 1u)) != 0
+#error "SMART_TIMER_QUEUE_SIZE must be a power of two"
+#endif
+
+/* 12MHz 内核时钟，与 smart_os_start 中的 SysTick 配置一致 */
+#define TIMER_CYCLES_PER_US  12u
+
 /* 定时器池 */
 static smart_timer_t timer_pool[MAX_TIMERS];
 static int timer_pool_init = 0;
 
-/* 活跃定时器链表 */
-static smart_timer_t *active_timer_list = NULL;
+/* 时间轮：各层各槽的定时器链表 */
+static smart_timer_t *timer_wheel[SMART_TIMER_WHEEL_LEVELS][WHEEL_SLOTS];
+
+/* 下一个待处理的 tick（处理完的 tick 之后一个） */
+static uint32_t wheel_tick = 0;
 
 /* 定时器ID计数器 */
 static uint32_t next_timer_id = 1;
@@ -19,11 +41,92 @@ static uint32_t next_timer_id = 1;
 /* 统计信息 */
 static timer_stats_t timer_stats = {0};
 
-/* 时间测量 */
-static uint32_t get_microseconds(void)
+#if SMART_TIMER_DAEMON
+/* 定时器服务任务 */
+static struct smart_task timer_task;
+static uint8_t timer_task_stack[SMART_TIMER_TASK_STACK_SIZE] SMART_SECTION_STACK;
+static smart_task_t timer_wait_list = NULL;
+
+/* 到期队列：SysTick 为唯一生产者，服务任务为唯一消费者。
+ * 元素为 (id << 8) | 池下标，定时器在队列中被删除或重新分配时可以识别出来。
+ */
+static uint32_t timer_queue_buf[SMART_TIMER_QUEUE_SIZE];
+static smart_spsc_ring_t timer_queue;
+
+static void timer_task_entry(void *param);
+#endif
+
+/* 以下时间轮操作均在临界区内调用 */
+static void wheel_link(smart_timer_t **head, smart_timer_t *timer)
+{
+    timer->next = *head;
+    timer->pprev = head;
+    if (*head)
+    {
+        (*head)->pprev = &timer->next;
+    }
+    *head = timer;
+}
+
+static void wheel_unlink(smart_timer_t *timer)
+{
+    if (!timer->pprev)
+    {
+        return;
+    }
+    
+    *timer->pprev = timer->next;
+    if (timer->next)
+    {
+        timer->next->pprev = timer->pprev;
+    }
+    timer->next = NULL;
+    timer->pprev = NULL;
+}
+
+/* 按距到期的 tick 数选择层，按到期时间选择槽 */
+static void wheel_insert(smart_timer_t *timer)
+{
+    uint32_t delta = timer->expire_tick - wheel_tick;
+    uint32_t slot_tick = timer->expire_tick;
+    uint32_t level = 0;
+    
+    if ((int32_t)delta < 0)
+    {
+        /* 已过期（处理滞后或回调中重新启动）：放入当前槽，本次就处理 */
+        slot_tick = wheel_tick;
+    }
+    else
+    {
+        if (delta >= WHEEL_RANGE)
+        {
+            /* 超出范围：先挂在最高层最远的槽，下移时重新计算 */
+            delta = WHEEL_RANGE - 1u;
+            slot_tick = wheel_tick + delta;
+        }
+        while (delta >= (1u << WHEEL_SHIFT(level + 1)))
+        {
+            level++;
+        }
+    }
+    
+    wheel_link(&timer_wheel[level][(slot_tick >> WHEEL_SHIFT(level)) & WHEEL_MASK], timer);
+}
+
+/* 把上层一个槽的定时器重新分配到下层 */
+static void wheel_cascade(uint32_t level, uint32_t index)
 {
-    /* 简单的微秒计数器，基于系统滴答 */
-    return smart_get_tick() * 1000;  /* 假设1ms滴答 */
+    smart_timer_t *timer = timer_wheel[level][index];
+    timer_wheel[level][index] = NULL;
+    
+    while (timer)
+    {
+        smart_timer_t *next = timer->next;
+        timer->next = NULL;
+        timer->pprev = NULL;
+        wheel_insert(timer);
+        timer = next;
+    }
 }
 
 /* 初始化定时器系统 */
@@ -36,10 +139,21 @@ void smart_timer_init(void)
     
     /* 初始化定时器池 */
     memset(timer_pool, 0, sizeof(timer_pool));
-    active_timer_list = NULL;
+    memset(timer_wheel, 0, sizeof(timer_wheel));
+    wheel_tick = smart_get_tick() + 1;
     next_timer_id = 1;
     memset(&timer_stats, 0, sizeof(timer_stats));
     
+#if SMART_TIMER_DAEMON
+    smart_spsc_ring_init(&timer_queue, timer_queue_buf, SMART_TIMER_QUEUE_SIZE);
+    timer_wait_list = NULL;
+    smart_task_create(&timer_task, timer_task_entry, 0,
+                      timer_task_stack, sizeof(timer_task_stack),
+                      0, 0);
+    /* 非周期任务的截止时间为无穷大，不会被选中；给一个有限截止时间，让它先运行到阻塞点 */
+    timer_task.deadline = smart_get_tick() + SMART_TIMER_TASK_DEADLINE;
+#endif
+    
     timer_pool_init = 1;
     
     smart_uart_print("[TIMER] Software timer system initialized\r\n");
@@ -72,23 +186,8 @@ static void free_timer(smart_timer_t *timer)
     
     smart_enter_critical();
     
-    /* 从活跃链表中移除 */
-    if (active_timer_list == timer)
-    {
-        active_timer_list = timer->next;
-    }
-    else
-    {
-        smart_timer_t *prev = active_timer_list;
-        while (prev && prev->next != timer)
-        {
-            prev = prev->next;
-        }
-        if (prev)
-        {
-            prev->next = timer->next;
-        }
-    }
+    /* 从时间轮中移除 */
+    wheel_unlink(timer);
     
     /* 清零定时器 */
     memset(timer, 0, sizeof(smart_timer_t));
@@ -101,7 +200,7 @@ static void free_timer(smart_timer_t *timer)
 timer_handle_t smart_timer_create(timer_type_t type, uint32_t period_ms, 
                                   timer_callback_t callback, void *arg)
 {
-    if (!callback || period_ms == 0)
+    if (!callback || period_ms == 0 || period_ms >= 0x80000000u)
     {
         return NULL;
     }
@@ -115,10 +214,13 @@ timer_handle_t smart_timer_create(timer_type_t type, uint32_t period_ms,
     timer->type = type;
     timer->state = TIMER_STOPPED;
     timer->period_ms = period_ms;
-    timer->remaining_ms = period_ms;
+    timer->expire_tick = 0;
     timer->callback = callback;
     timer->callback_arg = arg;
+    timer->context = TIMER_CONTEXT_TASK;
+    timer->pending = 0;
     timer->next = NULL;
+    timer->pprev = NULL;
     
     return timer;
 }
@@ -133,20 +235,16 @@ int smart_timer_start(timer_handle_t timer)
     
     smart_enter_critical();
     
-    /* 如果已经在活跃链表中，先移除 */
     if (timer->state == TIMER_RUNNING)
     {
         smart_exit_critical();
         return 0;  /* 已经在运行 */
     }
     
-    /* 重置剩余时间 */
-    timer->remaining_ms = timer->period_ms;
+    /* 从当前时刻开始计时 */
+    timer->expire_tick = smart_get_tick() + timer->period_ms;
     timer->state = TIMER_RUNNING;
-    
-    /* 添加到活跃链表头部 */
-    timer->next = active_timer_list;
-    active_timer_list = timer;
+    wheel_insert(timer);
     timer_stats.active_timers++;
     
     smart_exit_critical();
@@ -170,26 +268,8 @@ int smart_timer_stop(timer_handle_t timer)
         return 0;  /* 已经停止 */
     }
     
-    /* 从活跃链表中移除 */
-    if (active_timer_list == timer)
-    {
-        active_timer_list = timer->next;
-    }
-    else
-    {
-        smart_timer_t *prev = active_timer_list;
-        while (prev && prev->next != timer)
-        {
-            prev = prev->next;
-        }
-        if (prev)
-        {
-            prev->next = timer->next;
-        }
-    }
-    
+    wheel_unlink(timer);
     timer->state = TIMER_STOPPED;
-    timer->next = NULL;
     timer_stats.active_timers--;
     
     smart_exit_critical();
@@ -206,7 +286,11 @@ int smart_timer_reset(timer_handle_t timer)
     }
     
     smart_enter_critical();
-    timer->remaining_ms = timer->period_ms;
+    if (timer->state == TIMER_RUNNING)
+    {
+        wheel_unlink(timer);
+        timer_stats.active_timers--;
+    }
     timer->state = TIMER_STOPPED;
     smart_exit_critical();
     
@@ -230,20 +314,32 @@ int smart_timer_delete(timer_handle_t timer)
     return 0;
 }
 
-/* 修改定时器周期 */
-int smart_timer_set_period(timer_handle_t timer, uint32_t period_ms)
+/* 设置回调执行上下文 */
+int smart_timer_set_context(timer_handle_t timer, timer_context_t context)
 {
-    if (!timer || timer->id == 0 || period_ms == 0)
+    if (!timer || timer->id == 0 ||
+        (context != TIMER_CONTEXT_TASK && context != TIMER_CONTEXT_ISR))
     {
         return -1;
     }
     
     smart_enter_critical();
-    timer->period_ms = period_ms;
-    if (timer->state == TIMER_STOPPED)
+    timer->context = context;
+    smart_exit_critical();
+    
+    return 0;
+}
+
+/* 修改定时器周期（运行中的定时器在下一周期生效） */
+int smart_timer_set_period(timer_handle_t timer, uint32_t period_ms)
+{
+    if (!timer || timer->id == 0 || period_ms == 0 || period_ms >= 0x80000000u)
     {
-        timer->remaining_ms = period_ms;
+        return -1;
     }
+    
+    smart_enter_critical();
+    timer->period_ms = period_ms;
     smart_exit_critical();
     
     return 0;
@@ -257,7 +353,17 @@ uint32_t smart_timer_get_remaining(timer_handle_t timer)
         return 0;
     }
     
-    return timer->remaining_ms;
+    if (timer->state == TIMER_STOPPED)
+    {
+        return timer->period_ms;
+    }
+    if (timer->state != TIMER_RUNNING)
+    {
+        return 0;
+    }
+    
+    int32_t remaining = (int32_t)(timer->expire_tick - smart_get_tick());
+    return (remaining > 0) ? (uint32_t)remaining : 0;
 }
 
 /* 获取定时器状态 */
@@ -282,88 +388,200 @@ void smart_timer_get_stats(timer_stats_t *stats)
     }
 }
 
-/* 定时器系统滴答处理 */
-void smart_timer_tick(void)
+/* 执行回调并统计执行时间（在临界区外调用） */
+static void timer_run_callback(timer_callback_t callback, void *arg)
 {
-    if (!timer_pool_init)
+    uint32_t start_cycles = smart_get_cycles();
+    callback(arg);
+    uint32_t callback_time = (smart_get_cycles() - start_cycles) / TIMER_CYCLES_PER_US;
+    
+    smart_enter_critical();
+    if (callback_time > timer_stats.max_callback_time_us)
+    {
+        timer_stats.max_callback_time_us = callback_time;
+    }
+    timer_stats.callback_count++;
+    smart_exit_critical();
+}
+
+#if SMART_TIMER_DAEMON
+/* 把到期定时器投递给服务任务（临界区内调用） */
+static void timer_post(smart_timer_t *timer)
+{
+    /* 上一次到期尚未处理：合并为一次回调 */
+    if (timer->pending)
     {
+        timer_stats.overrun_count++;
         return;
     }
     
+    timer->post_cycles = smart_get_cycles();
+    if (!smart_spsc_ring_push(&timer_queue, (timer->id << 8) | (uint32_t)(timer - timer_pool)))
+    {
+        timer_stats.overrun_count++;
+        return;
+    }
+    
+    timer->pending = 1;
+    timer_stats.deferred_count++;
+}
+
+/* 服务任务执行一个已投递的回调 */
+static void timer_task_dispatch(uint32_t entry)
+{
+    smart_timer_t *timer = &timer_pool[entry & 0xFFu];
+    
     smart_enter_critical();
     
-    smart_timer_t *timer = active_timer_list;
-    smart_timer_t *prev = NULL;
+    /* 投递后被删除（或池位已分配给新定时器）：丢弃 */
+    if ((timer->id << 8) != (entry & ~0xFFu))
+    {
+        smart_exit_critical();
+        return;
+    }
     
-    while (timer)
+    timer->pending = 0;
+    
+    /* 投递后被停止：不再执行 */
+    if (timer->state == TIMER_STOPPED)
     {
-        smart_timer_t *next = timer->next;
+        smart_exit_critical();
+        return;
+    }
+    
+    timer_callback_t callback = timer->callback;
+    void *arg = timer->callback_arg;
+    
+    uint32_t latency = (smart_get_cycles() - timer->post_cycles) / TIMER_CYCLES_PER_US;
+    if (latency > timer_stats.max_latency_us)
+    {
+        timer_stats.max_latency_us = latency;
+    }
+    if (timer_stats.avg_latency_us == 0)
+    {
+        timer_stats.avg_latency_us = latency;
+    }
+    else
+    {
+        timer_stats.avg_latency_us = (latency + 7u * timer_stats.avg_latency_us) / 8u;
+    }
+    
+    smart_exit_critical();
+    
+    timer_run_callback(callback, arg);
+}
+
+static void timer_task_entry(void *param)
+{
+    (void)param;
+    
+    while (1)
+    {
+        uint32_t entry;
+        if (smart_spsc_ring_pop(&timer_queue, &entry))
+        {
+            timer_task_dispatch(entry);
+            continue;
+        }
         
-        if (timer->remaining_ms > 0)
+        /* 队列为空：在临界区内复查后阻塞，SysTick 投递后唤醒 */
+        smart_enter_critical();
+        if (smart_spsc_ring_count(&timer_queue) == 0)
+        {
+            smart_task_block(&timer_wait_list, SMART_WAIT_FOREVER);
+        }
+        smart_exit_critical();
+    }
+}
+#endif
+
+/* 处理当前槽中的一个到期定时器（临界区内调用，中断上下文回调执行期间开放中断） */
+static void timer_expire(smart_timer_t *timer)
+{
+    wheel_unlink(timer);
+    timer_stats.expired_count++;
+    
+    if (timer->type == TIMER_PERIODIC)
+    {
+        /* 回调之前重新挂入，回调中可以直接停止；按到期时间累加，不随处理延迟漂移 */
+        timer->expire_tick += timer->period_ms;
+        if ((int32_t)(timer->expire_tick - wheel_tick) <= 0)
         {
-            timer->remaining_ms--;
+            /* 错过了整个周期：从当前 tick 重新计时 */
+            timer->expire_tick = wheel_tick + timer->period_ms;
         }
+        wheel_insert(timer);
+    }
+    else
+    {
+        /* 单次定时器，保持EXPIRED状态 */
+        timer->state = TIMER_EXPIRED;
+        timer_stats.active_timers--;
+    }
+    
+    if (!timer->callback)
+    {
+        return;
+    }
+    
+#if SMART_TIMER_DAEMON
+    if (timer->context == TIMER_CONTEXT_TASK)
+    {
+        timer_post(timer);
+        return;
+    }
+#endif
+    
+    /* 中断上下文回调：执行时允许中断 */
+    timer_callback_t callback = timer->callback;
+    void *arg = timer->callback_arg;
+    smart_exit_critical();
+    timer_run_callback(callback, arg);
+    smart_enter_critical();
+}
+
+/* 定时器系统滴答处理：只访问当前 tick 的槽，每 2^BITS 个 tick 下移一次上层槽 */
+void smart_timer_tick(void)
+{
+    if (!timer_pool_init)
+    {
+        return;
+    }
+    
+    uint32_t now = smart_get_tick();
+    
+    smart_enter_critical();
+    
+    while ((int32_t)(now - wheel_tick) >= 0)
+    {
+        uint32_t index = wheel_tick & WHEEL_MASK;
         
-        /* 定时器到期 */
-        if (timer->remaining_ms == 0)
+        /* 下层转完一圈：上层当前槽中的定时器即将到期，重新分配到下层 */
+        for (uint32_t level = 1; index == 0 && level < SMART_TIMER_WHEEL_LEVELS; level++)
         {
-            timer->state = TIMER_EXPIRED;
-            timer_stats.expired_count++;
-            
-            /* 从活跃链表中移除 */
-            if (prev)
-            {
-                prev->next = next;
-            }
-            else
-            {
-                active_timer_list = next;
-            }
-            timer_stats.active_timers--;
-            
-            /* 执行回调函数 */
-            if (timer->callback)
-            {
-                smart_exit_critical();  /* 执行回调时允许中断 */
-                
-                uint32_t start_time = get_microseconds();
-                timer->callback(timer->callback_arg);
-                uint32_t end_time = get_microseconds();
-                
-                uint32_t callback_time = end_time - start_time;
-                if (callback_time > timer_stats.max_callback_time_us)
-                {
-                    timer_stats.max_callback_time_us = callback_time;
-                }
-                timer_stats.callback_count++;
-                
-                smart_enter_critical();
-            }
-            
-            /* 处理周期定时器 */
-            if (timer->type == TIMER_PERIODIC)
-            {
-                timer->remaining_ms = timer->period_ms;
-                timer->state = TIMER_RUNNING;
-                
-                /* 重新添加到活跃链表 */
-                timer->next = active_timer_list;
-                active_timer_list = timer;
-                timer_stats.active_timers++;
-            }
-            else
-            {
-                /* 单次定时器，保持EXPIRED状态 */
-                timer->next = NULL;
-            }
+            index = (wheel_tick >> WHEEL_SHIFT(level)) & WHEEL_MASK;
+            wheel_cascade(level, index);
         }
-        else
+        
+        /* 回调中启动的已到期定时器会挂入同一槽，一并处理 */
+        smart_timer_t **slot = &timer_wheel[0][wheel_tick & WHEEL_MASK];
+        while (*slot)
         {
-            prev = timer;
+            timer_expire(*slot);
         }
         
-        timer = next;
+        wheel_tick++;
+    }
+    
+#if SMART_TIMER_DAEMON
+    /* 有回调待执行：按相对截止时间唤醒服务任务 */
+    if (timer_wait_list && smart_spsc_ring_count(&timer_queue) != 0)
+    {
+        timer_task.deadline = now + SMART_TIMER_TASK_DEADLINE;
+        smart_task_wakeup(timer_wait_list, SMART_WAIT_OK);
+        smart_schedule();
     }
+#endif
     
     smart_exit_critical();
 }
@@ -372,7 +590,7 @@ void smart_timer_tick(void)
 void smart_timer_list(void)
 {
     smart_uart_print("=== Timer List ===\r\n");
-    smart_uart_print("ID   Type      State     Period(ms) Remaining(ms)\r\n");
+    smart_uart_print("ID   Type      Ctx   State     Period(ms) Remaining(ms)\r\n");
     smart_uart_print("------------------------------------------------\r\n");
     
     smart_enter_critical();
@@ -396,6 +614,8 @@ void smart_timer_list(void)
                 smart_uart_print("Periodic  ");
             }
             
+            smart_uart_print((timer->context == TIMER_CONTEXT_ISR) ? "ISR   " : "Task  ");
+            
             switch (timer->state)
             {
                 case TIMER_STOPPED:
@@ -412,7 +632,7 @@ void smart_timer_list(void)
             smart_uart_print("0x");
             smart_uart_print_hex32(timer->period_ms);
             smart_uart_print("     0x");
-            smart_uart_print_hex32(timer->remaining_ms);
+            smart_uart_print_hex32(smart_timer_get_remaining(timer));
             smart_uart_print("\r\n");
         }
     }
@@ -431,4 +651,15 @@ void smart_timer_list(void)
     smart_uart_print("\r\nMax Callback Time: 0x");
     smart_uart_print_hex32(timer_stats.max_callback_time_us);
     smart_uart_print(" us\r\n");
+#if SMART_TIMER_DAEMON
+    smart_uart_print("Deferred Count: 0x");
+    smart_uart_print_hex32(timer_stats.deferred_count);
+    smart_uart_print("\r\nOverrun Count: 0x");
+    smart_uart_print_hex32(timer_stats.overrun_count);
+    smart_uart_print("\r\nCallback Latency: avg 0x");
+    smart_uart_print_hex32(timer_stats.avg_latency_us);
+    smart_uart_print(" us, max 0x");
+    smart_uart_print_hex32(timer_stats.max_latency_us);
+    smart_uart_print(" us\r\n");
+#endif
 }
\ No newline at end of file
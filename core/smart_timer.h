@@ -16,22 +16,66 @@ typedef enum {
     TIMER_EXPIRED = 2      /* 已过期状态 */
 } timer_state_t;
 
+/* 回调执行上下文 */
+typedef enum {
+    TIMER_CONTEXT_TASK = 0,    /* 由定时器服务任务执行（默认） */
+    TIMER_CONTEXT_ISR = 1      /* 在 SysTick 中断中直接执行，仅用于必须留在中断中的短回调 */
+} timer_context_t;
+
 /* 定时器回调函数类型 */
 typedef void (*timer_callback_t)(void *arg);
 
 /* 定时器句柄 */
 typedef struct smart_timer* timer_handle_t;
 
+/* 分层时间轮：共 SMART_TIMER_WHEEL_LEVELS 层，每层 2^SMART_TIMER_WHEEL_BITS 个槽，
+ * 第 n 层每槽跨 2^(BITS*n) 个 tick。定时器按绝对到期 tick 挂入对应槽，
+ * 启动/停止/到期均为 O(1)；低层转完一圈时把上层当前槽的定时器重新分配到下层。
+ * 超出时间轮范围（默认 2^16 tick）的定时器先挂在最高层，逐级下移。
+ */
+#ifndef SMART_TIMER_WHEEL_BITS
+#define SMART_TIMER_WHEEL_BITS    4
+#endif
+
+#ifndef SMART_TIMER_WHEEL_LEVELS
+#define SMART_TIMER_WHEEL_LEVELS  4
+#endif
+
+/* 定时器服务任务：SysTick 只把到期定时器写入无锁队列并唤醒服务任务，
+ * 回调在任务上下文中执行，慢回调不再拖延 tick 中断和其后的 EDF 唤醒。
+ * 服务任务每次被唤醒时截止时间设为 当前 tick + SMART_TIMER_TASK_DEADLINE，
+ * 按 EDF 与其他任务竞争；设为 0 关闭服务任务，全部回调回到中断中执行。
+ */
+#ifndef SMART_TIMER_DAEMON
+#define SMART_TIMER_DAEMON           1
+#endif
+
+#ifndef SMART_TIMER_TASK_DEADLINE
+#define SMART_TIMER_TASK_DEADLINE    5u     /* 服务任务相对截止时间(tick) */
+#endif
+
+#ifndef SMART_TIMER_TASK_STACK_SIZE
+#define SMART_TIMER_TASK_STACK_SIZE  512u
+#endif
+
+#ifndef SMART_TIMER_QUEUE_SIZE
+#define SMART_TIMER_QUEUE_SIZE       16u    /* 到期队列容量，必须为 2 的幂 */
+#endif
+
 /* 定时器控制块 */
 typedef struct smart_timer {
     uint32_t id;                    /* 定时器ID */
     timer_type_t type;              /* 定时器类型 */
     timer_state_t state;            /* 定时器状态 */
     uint32_t period_ms;             /* 定时周期(毫秒) */
-    uint32_t remaining_ms;          /* 剩余时间(毫秒) */
+    uint32_t expire_tick;           /* 绝对到期时间(tick，运行状态下有效) */
     timer_callback_t callback;      /* 回调函数 */
     void *callback_arg;             /* 回调参数 */
-    struct smart_timer *next;       /* 链表指针 */
+    timer_context_t context;        /* 回调执行上下文 */
+    volatile uint32_t pending;      /* 已投递给服务任务、回调尚未执行 */
+    uint32_t post_cycles;           /* 投递时刻(CPU周期)，用于统计回调延迟 */
+    struct smart_timer *next;       /* 时间轮槽内链表 */
+    struct smart_timer **pprev;     /* 指向前一节点的 next（或槽头），不在槽内时为 NULL */
 } smart_timer_t;
 
 /* 定时器统计信息 */
@@ -41,6 +85,10 @@ typedef struct {
     uint32_t expired_count;         /* 过期次数统计 */
     uint32_t callback_count;        /* 回调执行次数 */
     uint32_t max_callback_time_us;  /* 最大回调执行时间(微秒) */
+    uint32_t deferred_count;        /* 投递给服务任务执行的回调次数 */
+    uint32_t overrun_count;         /* 上次回调尚未执行又到期（合并为一次）或队列已满 */
+    uint32_t max_latency_us;        /* 到期到回调开始执行的最大延迟(微秒，仅服务任务) */
+    uint32_t avg_latency_us;        /* 平均延迟(微秒，指数平均) */
 } timer_stats_t;
 
 /* 初始化定时器系统 */
@@ -62,6 +110,9 @@ int smart_timer_reset(timer_handle_t timer);
 /* 删除定时器 */
 int smart_timer_delete(timer_handle_t timer);
 
+/* 设置回调执行上下文（默认 TIMER_CONTEXT_TASK） */
+int smart_timer_set_context(timer_handle_t timer, timer_context_t context);
+
 /* 修改定时器周期 */
 int smart_timer_set_period(timer_handle_t timer, uint32_t period_ms);
 
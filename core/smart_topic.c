@@ -0,0 +1,227 @@
+#include "smart_topic.h"
+#include "smart_core.h"
+#include "smart_atomic.h"
+#include <string.h>
+
+/* 主题注册表 */
+static smart_topic_t *topic_list = NULL;
+
+static int smart_topic_match(const smart_topic_sub_t *sub, uint32_t type)
+{
+    return (type & sub->type_mask) == sub->type_value;
+}
+
+smart_msgq_status_t smart_topic_init(smart_topic_t *topic, const char *name)
+{
+    if (!topic)
+    {
+        return SMART_MSGQ_INVALID;
+    }
+    
+    smart_enter_critical();
+    
+    /* 已注册的主题再次加入会使链表成环，需先 deinit */
+    for (const smart_topic_t *t = topic_list; t; t = t->next)
+    {
+        if (t == topic)
+        {
+            smart_exit_critical();
+            return SMART_MSGQ_INVALID;
+        }
+    }
+    
+    topic->name = name;
+    topic->subs = NULL;
+    topic->published = 0;
+    topic->next = topic_list;
+    topic_list = topic;
+    
+    smart_exit_critical();
+    
+    return SMART_MSGQ_OK;
+}
+
+void smart_topic_deinit(smart_topic_t *topic)
+{
+    if (!topic)
+    {
+        return;
+    }
+    
+    smart_enter_critical();
+    
+    smart_topic_t **link = &topic_list;
+    while (*link && *link != topic)
+    {
+        link = &(*link)->next;
+    }
+    if (*link)
+    {
+        *link = topic->next;
+    }
+    topic->subs = NULL;
+    topic->next = NULL;
+    
+    smart_exit_critical();
+}
+
+smart_topic_t *smart_topic_find(const char *name)
+{
+    if (!name)
+    {
+        return NULL;
+    }
+    
+    smart_enter_critical();
+    
+    smart_topic_t *topic = topic_list;
+    while (topic && (!topic->name || strcmp(topic->name, name) != 0))
+    {
+        topic = topic->next;
+    }
+    
+    smart_exit_critical();
+    
+    return topic;
+}
+
+smart_msgq_status_t smart_topic_subscribe(smart_topic_t *topic, smart_topic_sub_t *sub,
+                                          smart_msgqueue_t *queue,
+                                          uint32_t type_mask, uint32_t type_value)
+{
+    if (!topic || !sub || !queue)
+    {
+        return SMART_MSGQ_INVALID;
+    }
+    
+    smart_enter_critical();
+    
+    sub->queue = queue;
+    sub->type_mask = type_mask;
+    sub->type_value = type_value & type_mask;
+    sub->delivered = 0;
+    sub->dropped = 0;
+    
+    /* 已在链表中的订阅者只更新过滤条件和队列，不重复链接 */
+    smart_topic_sub_t *s = topic->subs;
+    while (s && s != sub)
+    {
+        s = s->next;
+    }
+    if (!s)
+    {
+        sub->next = topic->subs;
+        topic->subs = sub;
+    }
+    
+    smart_exit_critical();
+    
+    return SMART_MSGQ_OK;
+}
+
+void smart_topic_unsubscribe(smart_topic_t *topic, smart_topic_sub_t *sub)
+{
+    if (!topic || !sub)
+    {
+        return;
+    }
+    
+    smart_enter_critical();
+    
+    smart_topic_sub_t **link = &topic->subs;
+    while (*link && *link != sub)
+    {
+        link = &(*link)->next;
+    }
+    if (*link)
+    {
+        *link = sub->next;
+    }
+    sub->next = NULL;
+    
+    smart_exit_critical();
+}
+
+uint32_t smart_topic_publish(smart_topic_t *topic, const smart_msg_t *msg)
+{
+    if (!topic || !msg)
+    {
+        return 0;
+    }
+    
+    uint32_t delivered = 0;
+    
+    /* 整个投递过程在一个临界区内，订阅者链表不会在遍历中变化 */
+    smart_enter_critical();
+    
+    topic->published++;
+    for (smart_topic_sub_t *sub = topic->subs; sub; sub = sub->next)
+    {
+        if (!smart_topic_match(sub, msg->type))
+        {
+            continue;
+        }
+        
+        if (smart_msgqueue_send(sub->queue, msg) == SMART_MSGQ_OK)
+        {
+            sub->delivered++;
+            delivered++;
+        }
+        else
+        {
+            sub->dropped++;
+        }
+    }
+    
+    smart_exit_critical();
+    
+    return delivered;
+}
+
+uint32_t smart_topic_publish_ref(smart_topic_t *topic, uint32_t type,
+                                 void *payload, uint32_t length)
+{
+    if (!topic || !payload)
+    {
+        return 0;
+    }
+    
+    smart_msg_block_t *block = (smart_msg_block_t *)payload - 1;
+    uint32_t delivered = 0;
+    
+    smart_enter_critical();
+    
+    topic->published++;
+    for (smart_topic_sub_t *sub = topic->subs; sub; sub = sub->next)
+    {
+        if (!smart_topic_match(sub, type))
+        {
+            continue;
+        }
+        
+        /* 先为订阅者加引用；投递失败时调用者仍持有引用，计数不会归零，直接撤销 */
+        smart_atomic_inc(&block->refcount);
+        if (smart_msgqueue_send_ref(sub->queue, type, payload, length, 0) == SMART_MSGQ_OK)
+        {
+            sub->delivered++;
+            delivered++;
+        }
+        else
+        {
+            smart_atomic_dec(&block->refcount);
+            sub->dropped++;
+        }
+    }
+    
+    smart_exit_critical();
+    
+    /* 消耗调用者自己的引用（可能归还内存池，放在临界区外） */
+    smart_msg_release(payload);
+    
+    return delivered;
+}
+
+smart_topic_t *smart_topic_next(smart_topic_t *topic)
+{
+    return topic ? topic->next : topic_list;
+}
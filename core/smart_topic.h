@@ -0,0 +1,64 @@
+#ifndef __SMART_TOPIC_H__
+#define __SMART_TOPIC_H__
+
+#include <stdint.h>
+#include "smart_msgqueue.h"
+
+/* 发布/订阅主题总线
+ * 订阅者挂接一个消息队列和类型过滤条件 (type & type_mask) == type_value，
+ * 发布时在一次调用内投递给所有匹配的订阅者。
+ * 大载荷用零拷贝引用发布：所有订阅者共享同一个引用计数内存池块。
+ * 主题与订阅节点由调用者提供存储（静态或任务栈外），内核只负责链接。
+ */
+
+/* 订阅节点 */
+typedef struct smart_topic_sub
+{
+    smart_msgqueue_t *queue;        /* 订阅者的消息队列 */
+    uint32_t type_mask;             /* 类型过滤掩码（0 表示接收全部） */
+    uint32_t type_value;            /* 过滤值 */
+    uint32_t delivered;             /* 投递成功次数 */
+    uint32_t dropped;               /* 队列满丢弃次数 */
+    struct smart_topic_sub *next;   /* 同一主题的下一个订阅者 */
+} smart_topic_sub_t;
+
+/* 主题 */
+typedef struct smart_topic
+{
+    const char *name;               /* 主题名 */
+    smart_topic_sub_t *subs;        /* 订阅者链表 */
+    uint32_t published;             /* 发布次数 */
+    struct smart_topic *next;       /* 主题注册表链表 */
+} smart_topic_t;
+
+/* 初始化主题并加入注册表；主题已注册时返回 INVALID，需先 smart_topic_deinit */
+smart_msgq_status_t smart_topic_init(smart_topic_t *topic, const char *name);
+
+/* 从注册表移除主题 */
+void smart_topic_deinit(smart_topic_t *topic);
+
+/* 按名称查找主题，未找到返回 NULL */
+smart_topic_t *smart_topic_find(const char *name);
+
+/* 订阅：type_mask 为 0 时接收全部类型；sub 已订阅该主题时就地更新过滤条件和队列 */
+smart_msgq_status_t smart_topic_subscribe(smart_topic_t *topic, smart_topic_sub_t *sub,
+                                          smart_msgqueue_t *queue,
+                                          uint32_t type_mask, uint32_t type_value);
+
+/* 取消订阅 */
+void smart_topic_unsubscribe(smart_topic_t *topic, smart_topic_sub_t *sub);
+
+/* 发布小消息（按值复制到各订阅队列，非阻塞），返回投递成功的订阅者数 */
+uint32_t smart_topic_publish(smart_topic_t *topic, const smart_msg_t *msg);
+
+/* 发布零拷贝载荷（payload 来自 smart_msg_alloc）：
+ * 每个匹配的订阅者持有一个引用，调用者的引用在返回时被消耗
+ * 返回投递成功的订阅者数
+ */
+uint32_t smart_topic_publish_ref(smart_topic_t *topic, uint32_t type,
+                                 void *payload, uint32_t length);
+
+/* 遍历注册表（用于 shell 显示），从 NULL 开始 */
+smart_topic_t *smart_topic_next(smart_topic_t *topic);
+
+#endif
@@ -9,21 +9,24 @@
  * Flash 是 NOR Flash，可以直接通过内存映射访问
  */
 
-/* 文件系统存储配置
+/* 文件系统存储配置（地址与大小来自 link.lds）
  * 
  * QEMU 环境：使用 SRAM（Flash 是只读的）
- *   0x20000000 - 0x20000E3F: 程序使用的 BSS/堆栈（约 4KB）
- *   0x20004000 - 0x2000FFFF: 文件系统区域（48KB，可用）
+ *   .fs_ram 段：FSRAM 区，0x20004000 - 0x2000FFFF (48KB)
  * 
  * 真实硬件：使用 Flash
- *   0x00010000 - 0x0003FFFF: 文件系统区域 (192KB)
+ *   FSFLASH 区：0x00010000 - 0x0003FFFF (192KB)
  */
 #ifdef QEMU_ENV
-#define FLASH_FS_BASE_ADDR       0x20004000  /* SRAM 高地址区域，留出16KB给程序 */
-#define FLASH_FS_SIZE            (48 * 1024)  /* 48KB */
+extern uint8_t _sfs_ram[];
+extern uint8_t _efs_ram[];
+#define FLASH_FS_BASE_ADDR       ((uint32_t)_sfs_ram)
+#define FLASH_FS_SIZE            ((uint32_t)(_efs_ram - _sfs_ram))
 #else
-#define FLASH_FS_BASE_ADDR       0x00010000  /* Flash 高地址区域 */
-#define FLASH_FS_SIZE            (192 * 1024)  /* 192KB */
+extern uint8_t _sfs_flash[];
+extern uint8_t _efs_flash[];
+#define FLASH_FS_BASE_ADDR       ((uint32_t)_sfs_flash)
+#define FLASH_FS_SIZE            ((uint32_t)(_efs_flash - _sfs_flash))
 #endif
 
 /* LM3S6965 Flash 控制寄存器 */
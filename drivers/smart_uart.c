@@ -1,5 +1,6 @@
 #include "smart_uart.h"
 #include "smart_core.h"
+#include "smart_atomic.h"
 
 /* UART0 寄存器 (LM3S 系列) */
 #define UART0_DR    (*(volatile uint32_t *)0x4000C000)
@@ -21,12 +22,12 @@
 #define NVIC_EN0    (*(volatile uint32_t *)0xE000E100)  /* 中断使能 0-31 */
 #define NVIC_PRI1   (*(volatile uint32_t *)0xE000E404)  /* 优先级 4-7 */
 
-/* 接收缓冲区（环形缓冲区） */
-#define RX_BUFFER_SIZE 256
+/* 接收缓冲区（单生产者/单消费者环形缓冲区，索引见 smart_atomic.h）
+ * 中断是生产者，任务是消费者，读取无需关中断
+ */
+#define RX_BUFFER_SIZE 256  /* 必须为 2 的幂 */
 static volatile char rx_buffer[RX_BUFFER_SIZE];
-static volatile uint32_t rx_head = 0;  /* 写入位置 */
-static volatile uint32_t rx_tail = 0;  /* 读取位置 */
-static volatile uint32_t rx_count = 0; /* 缓冲区数据量 */
+static smart_spsc_index_t rx_index;
 
 /* 中断统计信息 */
 static volatile uint32_t rx_interrupt_count = 0;  /* 中断触发次数 */
@@ -78,9 +79,7 @@ void smart_uart_init(void)
     UART0_CTL |= 0x301;
 
     /* 初始化缓冲区和统计信息 */
-    rx_head = 0;
-    rx_tail = 0;
-    rx_count = 0;
+    smart_spsc_index_init(&rx_index, RX_BUFFER_SIZE);
     rx_interrupt_count = 0;
     rx_char_count = 0;
     rx_overflow_count = 0;
@@ -113,7 +112,7 @@ void smart_uart_print_hex32(uint32_t value)
 /* 检查是否有输入可用 */
 int smart_uart_input_available(void)
 {
-    return (rx_count > 0);
+    return smart_spsc_index_count(&rx_index) != 0;
 }
 
 /* 非阻塞读取一个字符 */
@@ -124,21 +123,17 @@ int smart_uart_getc_nonblock(char *c)
         return 0;
     }
     
-    smart_enter_critical();
+    uint32_t slot;
     
     /* 检查缓冲区是否有数据 */
-    if (rx_count == 0)
+    if (!smart_spsc_read_slot(&rx_index, &slot))
     {
-        smart_exit_critical();
         return 0;  /* 无数据 */
     }
     
-    /* 从缓冲区读取数据 */
-    *c = rx_buffer[rx_tail];
-    rx_tail = (rx_tail + 1) % RX_BUFFER_SIZE;
-    rx_count--;
-    
-    smart_exit_critical();
+    /* 从缓冲区读取数据，读完后再释放槽位 */
+    *c = rx_buffer[slot];
+    smart_spsc_read_commit(&rx_index);
     
     return 1;  /* 成功读取 */
 }
@@ -146,17 +141,14 @@ int smart_uart_getc_nonblock(char *c)
 /* 获取缓冲区中的数据量 */
 uint32_t smart_uart_rx_count(void)
 {
-    return rx_count;
+    return smart_spsc_index_count(&rx_index);
 }
 
 /* 清空接收缓冲区 */
 void smart_uart_rx_flush(void)
 {
-    smart_enter_critical();
-    rx_head = 0;
-    rx_tail = 0;
-    rx_count = 0;
-    smart_exit_critical();
+    /* 消费者侧丢弃全部数据 */
+    smart_spsc_read_flush(&rx_index);
 }
 
 /* 获取中断统计信息 */
@@ -186,12 +178,12 @@ void UART0_Handler(void)
             char ch = (char)(UART0_DR & 0xFF);
             rx_char_count++;  /* 统计接收字符数 */
             
-            /* 如果缓冲区未满，存入缓冲区 */
-            if (rx_count < RX_BUFFER_SIZE)
+            /* 如果缓冲区未满，存入缓冲区，写完数据后再发布索引 */
+            uint32_t slot;
+            if (smart_spsc_write_slot(&rx_index, &slot))
             {
-                rx_buffer[rx_head] = ch;
-                rx_head = (rx_head + 1) % RX_BUFFER_SIZE;
-                rx_count++;
+                rx_buffer[slot] = ch;
+                smart_spsc_write_commit(&rx_index);
             }
             else
             {
@@ -3,11 +3,14 @@
 #include "smart_core.h"
 #include "smart_uart.h"
 #include "smart_mempool.h"
+#include "smart_malloc.h"
+#include "smart_heap.h"
 #include "smart_block.h"
 #include "smart_fs.h"
 #include "smart_shell.h"
 #include "smart_msgqueue.h"
 #include "smart_banner.h"
+#include "smart_memmap.h"
 
 /* 功能开关 */
 #define ENABLE_SHELL                1
@@ -15,10 +18,14 @@
 #define ENABLE_DELAY_TEST           0
 #define ENABLE_STACK_OVERFLOW_TEST  0
 
-/* 任务栈 */
-uint8_t stack_a[1024];
-uint8_t stack_b[1024];
-uint8_t stack_shell[2048];  /* Shell需要更大栈空间（文件系统操作） */
+/* 任务栈（link.lds 中的 .stacks 段） */
+uint8_t stack_a[1024] SMART_SECTION_STACK;
+uint8_t stack_b[1024] SMART_SECTION_STACK;
+uint8_t stack_shell[1536] SMART_SECTION_STACK;  /* 扇区缓冲等大块临时数据取自 smart_scratch；未实测最深用量前保留 512 字节余量 */
+
+/* 链接脚本定义的堆区域 */
+extern uint8_t _sheap[];
+extern uint8_t _eheap[];
 
 struct smart_task task_a;
 struct smart_task task_b;
@@ -31,18 +38,13 @@ volatile int count_b = 0;
 #define MEMPOOL_BLOCK_SIZE   64u
 #define MEMPOOL_BLOCK_COUNT  8u
 #define MEMPOOL_OPS_PER_TICK 2u
+#define MEMPOOL_WAIT_MS      100u  /* 内存池为空时最多等待的时间 */
 
-static uint8_t telemetry_pool_buf[MEMPOOL_BLOCK_SIZE * MEMPOOL_BLOCK_COUNT];
+static uint8_t telemetry_pool_buf[SMART_MEMPOOL_BUFFER_SIZE(MEMPOOL_BLOCK_SIZE, MEMPOOL_BLOCK_COUNT)] SMART_SECTION_POOL;
 static smart_mempool_t telemetry_pool;
 static void *task_a_block = 0;
 static void *task_b_block = 0;
 
-/* 导出内存池指针供Shell访问 */
-smart_mempool_t *smart_get_mempool(void)
-{
-    return &telemetry_pool;
-}
-
 /* 文件系统测试：内置 Flash（真实硬件存储） */
 static smart_block_device_t *flash_dev = 0;
 
@@ -72,6 +74,9 @@ static void log_mempool_result(const char *task_name,
         case SMART_MEMPOOL_BUSY:
             smart_uart_print("BUSY");
             break;
+        case SMART_MEMPOOL_TIMEOUT:
+            smart_uart_print("TIMEOUT");
+            break;
         case SMART_MEMPOOL_INVALID:
         default:
             smart_uart_print("INVALID");
@@ -112,7 +117,7 @@ void task_a_entry(void *param)
         if ((count_a % 3) == 0 && task_a_block == 0)
         {
             void *blk = 0;
-            smart_mempool_status_t st = smart_mempool_alloc_try(&telemetry_pool, &blk);
+            smart_mempool_status_t st = smart_mempool_alloc(&telemetry_pool, &blk, MEMPOOL_WAIT_MS);
             log_mempool_result("TaskA", "alloc", st);
             if (st == SMART_MEMPOOL_OK)
             {
@@ -171,7 +176,7 @@ void task_b_entry(void *param)
         if (task_b_block == 0)
         {
             void *blk = 0;
-            smart_mempool_status_t st = smart_mempool_alloc_try(&telemetry_pool, &blk);
+            smart_mempool_status_t st = smart_mempool_alloc(&telemetry_pool, &blk, MEMPOOL_WAIT_MS);
             log_mempool_result("TaskB", "alloc", st);
             if (st == SMART_MEMPOOL_OK)
             {
@@ -194,18 +199,27 @@ void task_b_entry(void *param)
 
 int main(void)
 {
+    smart_memmap_init();
     smart_os_init();
     smart_uart_init();
     
     /* 显示启动横幅 */
     smart_print_banner();
     smart_print_boot_animation();
+    smart_memmap_print();
     
     smart_mempool_init(&telemetry_pool,
                        telemetry_pool_buf,
                        MEMPOOL_BLOCK_SIZE,
                        MEMPOOL_BLOCK_COUNT,
                        MEMPOOL_OPS_PER_TICK);
+    smart_mempool_set_name(&telemetry_pool, "telemetry");
+    
+    /* 分级分配器：16/32/64/128 字节 */
+    smart_malloc_init();
+    
+    /* TLSF 堆：使用链接脚本中的 .heap 段 */
+    smart_heap_init(_sheap, (size_t)(_eheap - _sheap));
     
     /* 文件系统测试：初始化内置 Flash（真实硬件存储） */
     smart_uart_print("\n=== File System Test ===\n");
@@ -258,14 +272,6 @@ int main(void)
     }
     smart_uart_print("=== End FS Test ===\n\n");
     
-    /* 调试：打印栈地址 */
-    smart_uart_print("stack_a address: 0x");
-    smart_uart_print_hex32((uint32_t)stack_a);
-    smart_uart_print("\n");
-    smart_uart_print("stack_b address: 0x");
-    smart_uart_print_hex32((uint32_t)stack_b);
-    smart_uart_print("\n");
-    
 #if ENABLE_SHELL
     /* Shell 任务：低优先级，不影响实时任务 */
     smart_uart_print("\n[Main] Creating Shell task...\n");